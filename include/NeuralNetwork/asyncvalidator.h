@@ -0,0 +1,92 @@
+#pragma once
+
+#include "NeuralNetwork/networkanalyzer.h"
+#include "NeuralNetwork/neuralnetwork.h"
+#include "Utilities/constants.h"
+#include "Utilities/transformpipeline.h"
+
+#include <future>
+#include <limits>
+#include <optional>
+
+namespace NeuralNetwork {
+
+/*
+ * Evaluates the validation data during the training (see --validateEvery) without stopping it:
+ * A validation copies the current parameters to a separate evaluation network, which computes the validation error on another thread.
+ * The parameters with the lowest validation error are kept, so that they can be restored after the training.
+ */
+class AsyncValidator
+{
+public:
+  /*
+   * The evaluation network needs the same structure as the trained network. The validation data has to outlive the validator.
+   */
+  AsyncValidator(Network& network, Network evaluationNetwork, DataPartIterator forEachValidationPart, Utilities::TransformPipeline const& pipeline);
+  ~AsyncValidator();
+
+  AsyncValidator(AsyncValidator const&) = delete;
+  AsyncValidator& operator=(AsyncValidator const&) = delete;
+
+  /*
+   * Starts the validation of the current parameters, which were trained for the given number of epochs.
+   * Returns false without waiting, if the previous validation is still running (the current parameters are not validated in this case).
+   */
+  bool start(uint32_t epoch);
+  /*
+   * Returns the validation error, if the running validation has finished since the last call, otherwise nullopt. Does not wait.
+   */
+  [[nodiscard]]
+  std::optional<double> poll();
+  /*
+   * Waits for the running validation and returns its error (nullopt, if no validation is running).
+   */
+  [[nodiscard]]
+  std::optional<double> finish();
+
+  /*
+   * Copies the parameters with the lowest validation error to the trained network. Returns false, if no validation has finished yet.
+   */
+  bool restoreBestParameters();
+  [[nodiscard]]
+  uint32_t getBestEpoch() const;
+  [[nodiscard]]
+  double getBestError() const;
+  /*
+   * Returns the number of finished validations in a row, whose error was not lower than the lowest error before.
+   */
+  [[nodiscard]]
+  uint32_t getNumberOfValidationsWithoutImprovement() const;
+
+  /*
+   * Writes the results of the finished validations (the best parameters, their error and epoch) to the given archive.
+   * A validation, which is still running, is not included.
+   */
+  void write(torch::serialize::OutputArchive& archive) const;
+  /*
+   * Reads the results, which were written with write(), from the given archive. Throws an exception, if they are invalid.
+   */
+  void read(torch::serialize::InputArchive& archive);
+
+private:
+  /*
+   * Takes the result of the finished validation and keeps the validated parameters, if they have the lowest error so far.
+   */
+  double takeResult();
+
+private:
+  Network& network;
+  Network evaluationNetwork;
+  NetworkAnalyzer evaluationAnalyzer;
+  DataPartIterator forEachValidationPart;
+
+  std::future<double> validation {};
+  uint32_t validatedEpoch = 0;
+
+  std::vector<torch::Tensor> bestParameters {};
+  uint32_t bestEpoch = 0;
+  double bestError = std::numeric_limits<double>::infinity();
+  uint32_t numberOfValidationsWithoutImprovement = 0;
+};
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+#include <future>
+
+namespace NeuralNetwork {
+
+/*
+ * Writes checkpoints of the training (see --checkpointEvery) to a file without pausing the training:
+ * A checkpoint is serialized in memory by the training thread, the file is written on a background thread.
+ * Each checkpoint is written to a temporary file first, which then replaces the previous one, so that the file always contains a complete checkpoint.
+ */
+class CheckpointWriter
+{
+public:
+  explicit CheckpointWriter(FilePath path);
+  /*
+   * Waits for the running write.
+   */
+  ~CheckpointWriter();
+
+  CheckpointWriter(CheckpointWriter const&) = delete;
+  CheckpointWriter& operator=(CheckpointWriter const&) = delete;
+
+  /*
+   * Serializes the given archive and starts writing it to the file. Waits for the previous write, if it is still running.
+   */
+  void write(torch::serialize::OutputArchive& archive);
+  /*
+   * Waits for the running write. Returns false, if the last write failed.
+   */
+  bool finish();
+
+private:
+  /*
+   * Writes the serialized checkpoint to the temporary file and renames it to the checkpoint file. Returns false on failure.
+   */
+  [[nodiscard]]
+  bool writeFile(std::string const& content) const;
+
+private:
+  FilePath path;
+  std::future<bool> writing {};
+};
+
+}
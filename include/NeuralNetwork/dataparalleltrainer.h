@@ -0,0 +1,78 @@
+#pragma once
+
+#include "NeuralNetwork/networkanalyzer.h"
+#include "NeuralNetwork/neuralnetwork.h"
+#include "Utilities/constants.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace NeuralNetwork {
+
+/*
+ * Computes the gradients of a batch with several worker threads (see --dataParallel):
+ * Each worker computes the gradients of its slice of the batch with its own replica of the network, which gets the current parameters
+ * before each batch. The gradients are summed in a tree without locks (worker i adds the gradients of the workers i + 1, i + 2, i + 4, ...,
+ * as long as i is a multiple of twice the distance), so that the trained network has the gradients of the whole batch for a single optimizer step.
+ * The calling thread is the first worker and uses the trained network itself.
+ */
+class DataParallelTrainer
+{
+public:
+  /*
+   * Starts a worker thread for each replica. The replicas need the same structure as the trained network.
+   */
+  DataParallelTrainer(Network& network, std::vector<Network> const& replicas);
+  ~DataParallelTrainer();
+
+  DataParallelTrainer(DataParallelTrainer const&) = delete;
+  DataParallelTrainer& operator=(DataParallelTrainer const&) = delete;
+
+  /*
+   * Adds the gradients of the loss (sum of the squared errors of the batch divided by the given normalization) to the gradients of the trained
+   * network. The result is the same as with a single forward and backward pass over the whole batch (except for the order of the summation).
+   * The errors of the predictions are added to the given accumulator.
+   */
+  void computeGradients(torch::Tensor const& inputs, torch::Tensor const& outputs, double lossNormalization, ErrorAccumulator& errors);
+
+private:
+  class Worker
+  {
+  public:
+    Network network {nullptr};
+    std::vector<torch::Tensor> parameters {};
+    torch::Tensor predictions {};
+    bool hasGradients = false;
+    std::exception_ptr error {};
+    std::atomic<uint64_t> finishedBatch = 0; // number of the last batch, whose gradients (including the added ones) are complete
+  };
+
+  /*
+   * Waits for the next batch and computes its slice until the trainer is destroyed (runs on the worker thread).
+   */
+  void runWorker(size_t workerIndex);
+  /*
+   * Computes the gradients of the slice of the given worker and adds the gradients of the workers below it in the tree.
+   */
+  void computeSlice(size_t workerIndex, uint64_t batch);
+
+private:
+  std::vector<std::unique_ptr<Worker>> workers {};
+  std::vector<std::thread> threads {};
+
+  // The current batch, which is only changed while no worker computes:
+  torch::Tensor inputs {};
+  torch::Tensor outputs {};
+  double lossNormalization = 1.0;
+  size_t numberOfActiveWorkers = 0;
+
+  uint64_t currentBatch = 0;
+  bool stopWorkers = false;
+  std::mutex mutex {};
+  std::condition_variable batchStarted {};
+};
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "NeuralNetwork/networkanalyzer.h"
+#include "NeuralNetwork/neuralnetwork.h"
+#include "NeuralNetwork/optimizer.h"
+#include "Utilities/constants.h"
+#include "Utilities/programoptions.h"
+
+#include <chrono>
+
+namespace NeuralNetwork {
+
+/*
+ * Trains the network row by row with several threads without any locks (Hogwild, see --hogwild):
+ * The first thread trains the network itself, each other thread has a replica of the network, whose parameters share their storage with the
+ * trained network. Each thread has its own gradients and optimizer, trains with its own shard of the rows and updates the shared parameters
+ * without waiting for the other threads, so the updates of the threads may overwrite each other occasionally. The result is not deterministic.
+ */
+class HogwildTrainer
+{
+public:
+  /*
+   * Creates a thread for the trained network and for each replica. The replicas need the same structure as the trained network,
+   * their parameters are replaced by the ones of the trained network.
+   */
+  HogwildTrainer(Network& network, std::vector<Network> const& replicas, Utilities::ProgramOptions const& options);
+
+  /*
+   * Sets the learning rate of the given epoch for the optimizers of all threads (see Optimizer::startEpoch).
+   */
+  void startEpoch(uint32_t epoch, uint32_t numberOfDeteriorationsInRow);
+  /*
+   * Trains with each row of the given data once. The rows are split into one consecutive shard per thread.
+   * The errors of the predictions (before each update) are added to the given accumulator.
+   */
+  void train(Dataset const& data, ErrorAccumulator& errors);
+
+  /*
+   * Returns the number of trained rows per second of each thread over all calls of train().
+   */
+  [[nodiscard]]
+  std::vector<double> getRowsPerSecond() const;
+
+private:
+  class Worker
+  {
+  public:
+    Network network {nullptr};
+    std::unique_ptr<Optimizer> optimizer {nullptr};
+    ErrorAccumulator errors {};
+    uint64_t numberOfTrainedRows = 0;
+    std::chrono::steady_clock::duration trainingTime {};
+  };
+
+  std::vector<Worker> workers {};
+};
+
+}
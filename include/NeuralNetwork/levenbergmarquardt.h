@@ -0,0 +1,73 @@
+#pragma once
+
+#include "NeuralNetwork/networkanalyzer.h"
+#include "NeuralNetwork/neuralnetwork.h"
+#include "Utilities/constants.h"
+
+namespace NeuralNetwork {
+
+/*
+ * Trains the network with the Levenberg-Marquardt algorithm (see --optimizer lm), which is suited for small networks:
+ * Each step solves the damped normal equations (J^T J + damping * I) delta = -J^T e with the Jacobian J of all outputs of all training rows
+ * and adapts the damping factor depending on whether the step reduced the error.
+ * The Jacobian is computed in slices of rows, only J^T J (numberOfParameters x numberOfParameters) is kept in memory.
+ * The network has to consist of linear layers, each followed by leaky_relu(0.2) (see NetworkImpl).
+ */
+class LevenbergMarquardt
+{
+public:
+  explicit LevenbergMarquardt(Network& network);
+
+  /*
+   * Performs one step with the training data of all parts, which are given by the iterator.
+   * Returns false, if no damping factor reduces the error anymore (the parameters are unchanged in this case).
+   * The errors of the network after the step (or before, if it failed) are stored in the given accumulator.
+   */
+  [[nodiscard]]
+  bool step(DataPartIterator const& forEachPart, ErrorAccumulator& errors);
+
+  /*
+   * Returns the approximate memory usage of a step for the given number of network parameters (J^T J and its factorization).
+   */
+  [[nodiscard]]
+  static uint64_t GetMemoryUsageInBytes(uint64_t numberOfParameters);
+
+  /*
+   * Writes the damping factor to the given archive.
+   */
+  void write(torch::serialize::OutputArchive& archive) const;
+  /*
+   * Reads the damping factor, which was written with write(), from the given archive. Throws an exception, if it is invalid.
+   */
+  void read(torch::serialize::InputArchive& archive);
+
+private:
+  /*
+   * Adds J^T J and J^T e (e: errors of the outputs) of the given rows to the normal equations.
+   */
+  void accumulateNormalEquations(Dataset const& rows, torch::Tensor& jacobianProduct, torch::Tensor& gradient) const;
+  /*
+   * Returns the Jacobian [numberOfRows * numberOut, numberOfParameters] of the outputs for the given inputs with respect to the parameters
+   * and the outputs [numberOfRows, numberOut] via the given tensor.
+   */
+  [[nodiscard]]
+  torch::Tensor calculateJacobian(torch::Tensor const& inputs, torch::Tensor& outputs) const;
+  /*
+   * Returns the sum of the squared errors of the network with the training data of all parts and adds the errors to the given accumulator.
+   */
+  [[nodiscard]]
+  double calculateSumOfSquaredErrors(DataPartIterator const& forEachPart, ErrorAccumulator& errors) const;
+  /*
+   * Returns the number of rows, whose Jacobian is computed at once.
+   */
+  [[nodiscard]]
+  size_t getRowsPerSlice(int64_t numberOfOutputs) const;
+
+private:
+  Network& network;
+  std::vector<torch::Tensor> parameters {}; // weight and bias of each layer
+  int64_t numberOfParameters = 0;
+  double damping;
+};
+
+}
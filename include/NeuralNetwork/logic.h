@@ -2,8 +2,10 @@
 
 #include "NeuralNetwork/networkanalyzer.h"
 #include "NeuralNetwork/neuralnetwork.h"
+#include "Utilities/compactencoding.h"
 #include "Utilities/constants.h"
 #include "Utilities/programoptions.h"
+#include "Utilities/transformpipeline.h"
 
 namespace NeuralNetwork {
 
@@ -17,10 +19,99 @@ public:
   bool performUserRequest(Utilities::ProgramOptions const& options);
 
 private:
+  using ChunkFunction = std::function<void(Dataset& rows, uint64_t firstRow)>;
+  using ChunkIterator = std::function<void(ChunkFunction const& function)>; // calls the given function for each chunk of the preprocessed data
+
+  /*
+   * Performs the user request without keeping the whole data in memory (see --memoryLimit).
+   * The input has to be a binary dataset file. The min/max calculation, the training and the evaluation read the data chunk by chunk,
+   * the chunks are scaled and normalized after they are read. The training data is processed in the same order as in memory.
+   */
+  [[nodiscard]]
+  bool performOutOfCoreRequest();
+  /*
+   * Configures the network and performs the training and the evaluation with the preprocessed data of all chunks, which are given by the iterators.
+   * The network is trained with the chunks of forEachChunkToTrain (e.g. the compact chunks of --compactStorage), which have to contain the same rows.
+   */
+  [[nodiscard]]
+  bool performChunkedRequest(uint64_t numberOfRows, ChunkIterator const& forEachChunk, ChunkIterator const& forEachChunkToTrain);
+  /*
+   * Creates the encoding of the compact storage format which the user defined (see --compactStorage) for the normalized value ranges.
+   */
+  [[nodiscard]]
+  std::shared_ptr<Utilities::CompactEncoding const> createCompactEncoding() const;
+  /*
+   * Reads the checkpoint, from which the training continues (see --resume), and sets the seed of the split into training and validation data.
+   * The rest of the checkpoint is restored by the following steps.
+   */
+  [[nodiscard]]
+  bool loadCheckpoint();
   /*
-   * Trains the neural network with the given data. If the data vector is empty, no training is performed.
+   * Creates the neural network and the analyzer and loads pre-trained weights or the weights of the checkpoint, if the user set them.
+   * Returns false, if the weights of the checkpoint do not match the network.
    */
-  void trainNetwork(DataVector const& data);
+  [[nodiscard]]
+  bool configureNetwork();
+  /*
+   * Creates a new neural network with the layers and the data type which the user defined.
+   */
+  [[nodiscard]]
+  Network createNetwork() const;
+  /*
+   * Returns the data type of the network parameters for the precision which the user defined.
+   */
+  [[nodiscard]]
+  torch::ScalarType getNetworkDataType() const;
+  /*
+   * Reads and preprocesses (scaling, min/max calculation and normalization) the input data.
+   * If a cache directory is set, the preprocessed data is taken from the cache, if possible, or stored in it otherwise.
+   */
+  [[nodiscard]]
+  bool loadPreprocessedData(Dataset& data);
+  /*
+   * Reads the input file, which can be a CSV file or a binary dataset file.
+   * The min/max values of the unscaled data (stored in a binary dataset file or collected while a CSV file is parsed) are returned via unscaledMinMax.
+   */
+  [[nodiscard]]
+  bool readInputData(Dataset& data, std::optional<MinMaxValues>& unscaledMinMax);
+  /*
+   * Reads the input data again and transforms it with the transform pipeline of the preprocessing (e.g. for the exact values of compact data).
+   */
+  [[nodiscard]]
+  bool reloadPreprocessedData(Dataset& data);
+  /*
+   * Scales and normalizes the given data in place with the transform pipeline and calculates (or reads) the min/max values.
+   */
+  [[nodiscard]]
+  bool preprocessData(Dataset& data, std::optional<MinMaxValues> const& unscaledMinMax);
+  /*
+   * Reads the min/max values (or the whole transform pipeline) from the file which the user defined or calculates them with the given function.
+   * Afterwards, the min/max values are checked and the normalization of the transform pipeline is precomputed.
+   */
+  [[nodiscard]]
+  bool determineMinMaxValues(std::function<void()> const& calculateMinMax);
+  /*
+   * Converts the input file to the binary dataset format and saves it to the file path which the user defined.
+   * If a memory limit is set, the input file is converted chunk by chunk.
+   */
+  [[nodiscard]]
+  bool convertInputFile();
+  /*
+   * Trains the neural network with the given data. If the dataset is empty, no training is performed.
+   * The validation data is only used during the training, if the user set --validateEvery.
+   * Returns false, if the training cannot be restored from the checkpoint.
+   */
+  [[nodiscard]]
+  bool trainNetwork(Dataset const& data, Dataset const& validationData);
+  /*
+   * Trains the neural network with the data of all parts, which are given by the iterator. The parts are iterated once per epoch.
+   * If the user set --validateEvery, the validation data (if given) is evaluated asynchronously during the training, the training stops early,
+   * if the validation error does not improve anymore, and the parameters with the lowest validation error are restored afterwards.
+   * The training continues from the checkpoint (see --resume) and writes checkpoints (see --checkpointEvery), if the user set them.
+   * Returns false, if the training cannot be restored from the checkpoint.
+   */
+  [[nodiscard]]
+  bool trainNetwork(DataPartIterator const& forEachPart, DataPartIterator const& forEachValidationPart);
   /*
    * Starts the interactive mode where the user can input values via the console. Following actions are performed with these values:
    * - normalization and scaling (if needed)
@@ -34,36 +125,23 @@ private:
   /*
    * Infers values from the neural network depending on the inputted data and outputs the results to console.
    */
-  void outputBehaviour(DataVector const& data);
+  void outputBehaviour(Dataset const& data);
   /*
    * Infers values from the neural network depending on the inputted data and outputs the results to a file in the given file path.
+   * If append is true, the results are appended to the file.
    */
-  void saveValuesToFile(DataVector const& data, std::string const& outputPath);
+  void saveValuesToFile(Dataset const& data, std::string const& outputPath, bool append = false);
   /*
    * Infers values from the neural network depending on the inputted data and
    * outputs the diff to the correct output to a file in the given file path.
-   * The saved diff can be absolute or relative.
+   * The saved diff can be absolute or relative. If append is true, the diff is appended to the file.
    */
-  void saveDiffToFile(DataVector const& data, std::string const& outputPath, bool outputRelativeDifference);
+  void saveDiffToFile(Dataset const& data, std::string const& outputPath, bool outputRelativeDifference, bool append = false);
   /*
    * Saves the minimum and maximum values from the current training data to the filepath which the user defined.
    * If the data got scaled, scaled min/max values are saved.
    */
   void saveMinMaxToFile() const;
-  /*
-   * Denormalizes an input tensor.
-   * If limitValues is true, the output is limited by the current min/max output values.
-   */
-  void denormalizeInputTensor(torch::Tensor& tensor, bool limitValues = false);
-  /*
-   * Denormalizes an output tensor.
-   * If limitValues is true, the output is limited by the current min/max output values.
-   */
-  void denormalizeOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor, bool limitValues = false);
-  /*
-   * Reverts the scaling on an output tensor.
-   */
-  void unscaleOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor) const;
   /*
    * Checks if the given min/max values are valid --> min != max
    */
@@ -76,7 +154,7 @@ private:
   Utilities::ProgramOptions options {};
 
   bool useMixedScaling = false;
-  TensorDataType normalizedMixedScalingThreshold = Utilities::DefaultValues::MIXED_SCALING_THRESHOLD;
+  Utilities::TransformPipeline pipeline {};
 
   MinMaxValues minMax = std::make_pair(MinMaxVector(), MinMaxVector());
   MinMaxVector& inputMinMax = minMax.first;
@@ -88,8 +166,11 @@ private:
 
   ProgressVector trainingProgress {};
 
+  uint64_t splitSeed = 0; // seed of the split into training and validation data
+  std::optional<torch::serialize::InputArchive> resumeArchive {};
+
   bool useBatchTraining = false;
-  BatchMap batchedTrainingData = BatchMap();
+  BatchVector batchedTrainingData = BatchVector();
 };
 
 }
@@ -2,60 +2,131 @@
 
 #include "NeuralNetwork/neuralnetwork.h"
 #include "Utilities/constants.h"
+#include "Utilities/transformpipeline.h"
 
 namespace NeuralNetwork {
 
-  using DenormalizeOutputTensorFunction = std::function<void(torch::Tensor const& inputTensor, torch::Tensor& outputTensor, bool limitValues)>;
-  using UnscaleOutputTensorFunction = std::function<void(torch::Tensor const& inputTensor, torch::Tensor& outputTensor)>;
+  /*
+   * Accumulates the squared errors of each output column, e.g. during a training pass, so that the mean squared error and R2
+   * are available without another forward pass over the data.
+   */
+  class ErrorAccumulator
+  {
+  public:
+    /*
+     * Adds the errors of the given predictions and expected outputs (a row [numberOut] or a matrix [numberOfRows, numberOut]).
+     */
+    void add(torch::Tensor const& predictions, torch::Tensor const& outputs);
+    /*
+     * Adds the errors of the given accumulator.
+     */
+    void add(ErrorAccumulator const& other);
+    void reset();
+
+    [[nodiscard]]
+    bool empty() const;
+    [[nodiscard]]
+    size_t getNumberOfRows() const;
+    /*
+     * Returns the mean squared error of all added values.
+     */
+    [[nodiscard]]
+    double getMeanSquaredError() const;
+    /*
+     * Returns R2 of each output column with the given variances of the output columns (see NetworkAnalyzer::calculateOutputVariances).
+     */
+    [[nodiscard]]
+    std::vector<double> getR2Score(std::vector<double> const& outputVariances) const;
+
+    /*
+     * Writes the accumulated errors to the given archive.
+     */
+    void write(torch::serialize::OutputArchive& archive) const;
+    /*
+     * Reads the accumulated errors, which were written with write(), from the given archive. Throws an exception, if they are invalid.
+     */
+    void read(torch::serialize::InputArchive& archive);
+
+  private:
+    std::vector<double> squaredErrors {}; // sum of each column [numberOut]
+    size_t numberOfRows = 0;
+  };
 
   class NetworkAnalyzer
   {
   public:
     /*
      * Constructor of the NetworkAnalyzer class.
-     * Required are a reference to neural network instance and two function pointers which denormalize and unscale an output tensor.
+     * Required are a reference to neural network instance and a reference to the transform pipeline which denormalizes and unscales output tensors.
      */
-    explicit NetworkAnalyzer(Network& network, DenormalizeOutputTensorFunction denormalizationFunction, UnscaleOutputTensorFunction unscaleFunction);
+    explicit NetworkAnalyzer(Network& network, Utilities::TransformPipeline const& pipeline);
 
   public:
     /*
      * Calculates and returns the mean square error with the given data.
      */
     [[nodiscard]]
-    double calculateMeanSquaredError(DataVector const& testData);
+    double calculateMeanSquaredError(Dataset const& testData);
+    /*
+     * Calculates and returns the mean square error with the data of all parts, which are given by the iterator.
+     */
+    [[nodiscard]]
+    double calculateMeanSquaredError(DataPartIterator const& forEachPart);
+    /*
+     * Adds the errors of the network for the data of all parts, which are given by the iterator, to the accumulator.
+     * The rows are inferred in batches.
+     */
+    void accumulateErrors(DataPartIterator const& forEachPart, ErrorAccumulator& errors);
+    /*
+     * Returns the predictions of the network for all rows of the given data as matrix [numberOfRows, numberOut] of TORCH_DATA_TYPE.
+     * The rows are inferred in batches without gradients.
+     */
+    [[nodiscard]]
+    torch::Tensor predict(Dataset const& data);
+    /*
+     * Calculates the variance of each output column of the data of all parts, which are given by the iterator (no inference needed).
+     */
+    [[nodiscard]]
+    static std::vector<double> calculateOutputVariances(DataPartIterator const& forEachPart);
     /*
      * Calculates R2 for the given data.
      * WARNING: this method is numerical unstable. Use calculateR2ScoreAlternate to get a more stable output.
      */
     [[nodiscard]]
-    std::vector<double> calculateR2Score(DataVector const& testData);
+    std::vector<double> calculateR2Score(Dataset const& testData);
     /*
      * Calculates R2 for the given data.
      */
     [[nodiscard]]
-    std::vector<double> calculateR2ScoreAlternate(DataVector const& testData);
+    std::vector<double> calculateR2ScoreAlternate(Dataset const& testData);
+    /*
+     * Calculates R2 for the data of all parts, which are given by the iterator. Only the current part has to be kept in memory.
+     * The parts are iterated twice: once for the errors (see accumulateErrors) and once for the variances (see calculateOutputVariances).
+     * The result is the same as calculateR2ScoreAlternate for a single part.
+     */
+    [[nodiscard]]
+    std::vector<double> calculateR2ScoreAlternate(DataPartIterator const& forEachPart);
     /*
      * Calculates R2 for the given data after the values are denormalized.
      */
     [[nodiscard]]
-    std::vector<double> calculateR2ScoreAlternateDenormalized(DataVector const& testData);
+    std::vector<double> calculateR2ScoreAlternateDenormalized(Dataset const& testData);
 
   public:
     /*
-     * Calculates the difference of the two given tensors.
+     * Calculates the (element-wise) difference of the two given tensors.
      */
     [[nodiscard]]
     static torch::Tensor calculateDiff(torch::Tensor const& wantedValue, torch::Tensor const& actualValue);
     /*
-     * Calculates the relative difference of the two given tensors.
+     * Calculates the (element-wise) relative difference of the two given tensors.
      */
     [[nodiscard]]
     static torch::Tensor calculateRelativeDiff(torch::Tensor const& wantedValue, torch::Tensor const& actualValue);
 
   private:
     Network& network;
-    DenormalizeOutputTensorFunction denormalizeOutputTensor;
-    UnscaleOutputTensorFunction unscaleOutputTensor;
+    Utilities::TransformPipeline const& pipeline;
   };
 
 }
@@ -10,13 +10,13 @@ public:
   /*
    * Constructor which creates a new neural network instance with the given number of input and output nodes.
    * Also using the given definition of the hidden layers. Each value in the hiddenLayers vector
-   * defines a new hidden layer with the corresponding number of nodes.
+   * defines a new hidden layer with the corresponding number of nodes. The parameters of the network and its computations use the given data type.
    */
-  NetworkImpl(uint32_t numberOfInputNodes, uint32_t numberOfOutputNode, std::vector<uint32_t> const& hiddenLayers);
+  NetworkImpl(uint32_t numberOfInputNodes, uint32_t numberOfOutputNode, std::vector<uint32_t> const& hiddenLayers, torch::ScalarType dataType);
 
 public:
   /*
-   * Infers the output tensor with the given input tensor.
+   * Infers the output tensor with the given input tensor. The input tensor is converted to the data type of the network, if needed.
    */
   [[nodiscard]]
   torch::Tensor forward(torch::Tensor x);
@@ -29,6 +29,7 @@ private:
 
 private:
   std::vector<torch::nn::Sequential> layers{};
+  torch::ScalarType dataType;
 };
 
 /*
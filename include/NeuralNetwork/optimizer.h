@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Utilities/programoptions.h"
+
+#include <torch/torch.h>
+
+namespace NeuralNetwork {
+
+/*
+ * Updates the parameters of the network with the optimizer and the learning rate schedule which the user defined (see --optimizer and --lrSchedule).
+ * Levenberg-Marquardt is performed by the class LevenbergMarquardt, for it this class does nothing.
+ */
+class Optimizer
+{
+public:
+  /*
+   * Creates the optimizer for the given parameters with the options of the user.
+   */
+  Optimizer(std::vector<torch::Tensor> const& parameters, Utilities::ProgramOptions const& options);
+
+  /*
+   * Sets the gradients of all parameters to zero.
+   */
+  void zeroGrad();
+  /*
+   * Updates the parameters with their current gradients.
+   * L-BFGS needs a closure, which zeroes the gradients, computes the loss with all training data and its gradients and returns the loss.
+   */
+  void step(std::function<torch::Tensor()> const& closure = nullptr);
+  /*
+   * Sets the learning rate of the given epoch (starting at 1) according to the schedule.
+   * The number of epochs in a row without an improvement of at least epsilon is used by the reduce-on-plateau schedule.
+   */
+  void startEpoch(uint32_t epoch, uint32_t numberOfDeteriorationsInRow);
+
+  /*
+   * Writes the learning rate and the state of the optimizer (e.g. momentum buffers) to the given archive.
+   */
+  void write(torch::serialize::OutputArchive& archive) const;
+  /*
+   * Reads the state, which was written with write() by an optimizer with the same options, from the given archive.
+   * Throws an exception, if the archive does not contain a valid state.
+   */
+  void read(torch::serialize::InputArchive& archive);
+
+private:
+  void setLearnRate(double learnRate);
+
+private:
+  Utilities::ProgramOptions const& options;
+  std::unique_ptr<torch::optim::Optimizer> optimizer {nullptr};
+  std::vector<torch::Tensor> parameters {};
+  double learnRate;
+};
+
+}
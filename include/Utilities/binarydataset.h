@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+#include <optional>
+
+namespace Utilities {
+
+/*
+ * Binary dataset format (version 1), all values in native byte order:
+ * - fixed size file header (identifier, version, data type, number of rows/columns, offsets)
+ * - header line of the original CSV file
+ * - min/max value pair of each input and output column
+ * - zero padding up to the next page boundary
+ * - all input columns followed by all output columns, each column is stored contiguously and starts at a cache line boundary
+ */
+class BinaryDataset
+{
+public:
+  /*
+   * Returns true if the given file starts with the identifier of the binary dataset format.
+   */
+  [[nodiscard]]
+  static bool IsBinaryDatasetFile(FilePath const& path);
+  /*
+   * Saves the given data in the binary dataset format together with the file header and the min/max values of each column.
+   */
+  static bool Save(FilePath const& path, Dataset const& data, std::string const& fileHeader, MinMaxValues const& minMax);
+  /*
+   * Memory-maps the given binary dataset file and returns the data without copying it. The returned matrices are column-major views of the mapping.
+   * The mapping is read-only, so its pages are shared with other processes via the page cache and the returned tensors must not be changed
+   * (changing them crashes the process). Use Dataset::clone to get changeable matrices.
+   * The stored file header and the stored min/max values are returned via the given references.
+   */
+  [[nodiscard]]
+  static std::optional<Dataset> Load(FilePath const& path, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables, std::string& fileHeader,
+                                     MinMaxValues& minMax);
+};
+
+/*
+ * Writes a binary dataset file chunk by chunk. The number of rows has to be known in advance, the chunks can be written in any order.
+ */
+class BinaryDatasetWriter
+{
+public:
+  /*
+   * Creates the file with its final size and writes the meta data.
+   */
+  BinaryDatasetWriter(FilePath const& path, std::string const& fileHeader, uint64_t numberOfRows, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables);
+  ~BinaryDatasetWriter();
+
+  BinaryDatasetWriter(BinaryDatasetWriter const&) = delete;
+  BinaryDatasetWriter& operator=(BinaryDatasetWriter const&) = delete;
+
+  [[nodiscard]]
+  bool isOpen() const;
+  /*
+   * Writes the given rows to the file, starting at the given row index.
+   */
+  [[nodiscard]]
+  bool writeRows(uint64_t firstRow, Dataset const& rows);
+  /*
+   * Writes the min/max values of each column and closes the file.
+   */
+  [[nodiscard]]
+  bool finish(MinMaxValues const& minMax);
+
+private:
+  FilePath path;
+  int fileDescriptor = -1;
+  uint64_t numberOfRows = 0;
+  uint64_t columnStride = 0;
+  uint64_t minMaxOffset = 0;
+  uint64_t dataOffset = 0;
+};
+
+/*
+ * Reads rows of a binary dataset file on demand, without mapping or loading the whole file.
+ */
+class BinaryDatasetReader
+{
+public:
+  /*
+   * Opens the given file and reads its meta data. Errors are printed to the console.
+   */
+  BinaryDatasetReader(FilePath const& path, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables);
+  ~BinaryDatasetReader();
+
+  BinaryDatasetReader(BinaryDatasetReader const&) = delete;
+  BinaryDatasetReader& operator=(BinaryDatasetReader const&) = delete;
+
+  [[nodiscard]]
+  bool isOpen() const;
+  [[nodiscard]]
+  uint64_t getNumberOfRows() const;
+  [[nodiscard]]
+  std::string const& getFileHeader() const;
+  [[nodiscard]]
+  MinMaxValues const& getMinMax() const;
+  /*
+   * Reads the given rows. The returned matrices are column-major views into a buffer, which only contains the requested rows.
+   */
+  [[nodiscard]]
+  std::optional<Dataset> readRows(uint64_t firstRow, uint64_t numberOfRowsToRead) const;
+
+private:
+  FilePath path;
+  int fileDescriptor = -1;
+  uint32_t numberOfInputVariables = 0;
+  uint32_t numberOfOutputVariables = 0;
+  uint64_t numberOfRows = 0;
+  uint64_t columnStride = 0;
+  uint64_t dataOffset = 0;
+  std::string fileHeader {};
+  MinMaxValues minMax {};
+};
+
+}
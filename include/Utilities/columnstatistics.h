@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+namespace Utilities {
+
+/*
+ * Accumulates the number of rows and the minimum, maximum, mean and variance of each column.
+ * Accumulators of different parts of the data (threads, chunks, files) can be merged in any order, so the statistics of
+ * sharded or streamed data never need a second pass over the data.
+ */
+class ColumnStatistics
+{
+public:
+  /*
+   * Creates an empty accumulator. Merging another accumulator into it takes over the number of columns of the other one.
+   */
+  ColumnStatistics() = default;
+  explicit ColumnStatistics(size_t numberOfColumns);
+
+  /*
+   * Adds the rows of a row-major buffer, which contains getNumberOfColumns() values per row.
+   * If a row mask is given, only the rows whose mask value equals the selected value are added.
+   */
+  void addRows(TensorDataType const* values, int64_t numberOfRows, uint8_t const* rowMask = nullptr, uint8_t selectedValue = 1);
+  /*
+   * Merges the statistics of another part of the data into this accumulator. An empty accumulator has no effect.
+   */
+  void merge(ColumnStatistics const& other);
+
+  [[nodiscard]]
+  uint64_t getCount() const;
+  [[nodiscard]]
+  size_t getNumberOfColumns() const;
+  [[nodiscard]]
+  TensorDataType getMinimum(size_t column) const;
+  [[nodiscard]]
+  TensorDataType getMaximum(size_t column) const;
+  [[nodiscard]]
+  TensorDataType getMean(size_t column) const;
+  /*
+   * Returns the (population) variance of the given column.
+   */
+  [[nodiscard]]
+  TensorDataType getVariance(size_t column) const;
+  /*
+   * Returns the min/max value pair of each column or an empty vector, if no rows were added.
+   */
+  [[nodiscard]]
+  MinMaxVector getMinMaxVector() const;
+
+private:
+  void merge(uint64_t otherCount, TensorDataType const* otherMinimum, TensorDataType const* otherMaximum, TensorDataType const* otherMean, TensorDataType const* otherM2);
+
+private:
+  uint64_t count = 0;
+  std::vector<TensorDataType> minimum {};
+  std::vector<TensorDataType> maximum {};
+  std::vector<TensorDataType> mean {};
+  std::vector<TensorDataType> m2 {}; // sum of the squared differences to the mean
+};
+
+/*
+ * Statistics of the input and output columns of a dataset.
+ */
+class DatasetStatistics
+{
+public:
+  ColumnStatistics inputs;
+  ColumnStatistics outputs;
+
+  void merge(DatasetStatistics const& other);
+  [[nodiscard]]
+  MinMaxValues getMinMax() const;
+};
+
+/*
+ * Statistics of a dataset with respect to an active mixed scaling: the statistics of the input columns refer to all rows,
+ * the statistics of the output columns are split by the threshold of the mixed scaling input variable.
+ */
+class MixedDatasetStatistics
+{
+public:
+  ColumnStatistics inputs;
+  ColumnStatistics outputsBelowOrEqualThreshold;
+  ColumnStatistics outputsAboveThreshold;
+
+  void merge(MixedDatasetStatistics const& other);
+  [[nodiscard]]
+  MixedMinMaxValues getMixedMinMax() const;
+};
+
+}
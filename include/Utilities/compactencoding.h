@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+namespace Utilities {
+
+/*
+ * Compact in-memory encoding of preprocessed data with 2 bytes per value (a quarter of the size of double values):
+ * - Float16: half precision floating point values
+ * - Fixed16: 16-bit fixed point values relative to the value range of each column. Values outside of the range are saturated.
+ * A compact dataset (see Dataset::compact) stores the codes in its matrices and decodes them, when its values are read, e.g. batch by batch
+ * when the rows of a batch are gathered.
+ */
+class CompactEncoding
+{
+public:
+  enum class Format : uint8_t
+  {
+    Float16, Fixed16
+  };
+
+  /*
+   * Creates the encoding for the given value ranges (min/max value pair of each input and output column), which are only used by Fixed16.
+   */
+  CompactEncoding(Format format, MinMaxValues const& valueRanges);
+
+  /*
+   * Returns the data type of the codes.
+   */
+  [[nodiscard]]
+  torch::ScalarType getCodeType() const;
+  /*
+   * Encodes the given input (or output, if isOutput is true) matrix into a new code matrix.
+   * Throws a std::runtime_error, if a value is not finite (or too large for Float16), instead of saturating it silently.
+   */
+  [[nodiscard]]
+  torch::Tensor encode(torch::Tensor const& values, bool isOutput) const;
+  /*
+   * Decodes the given input (or output) codes, a matrix or a single row, to a new tensor of the given data type.
+   */
+  [[nodiscard]]
+  torch::Tensor decode(torch::Tensor const& codes, bool isOutput, torch::ScalarType dataType) const;
+  /*
+   * Decodes the given rows of the input (or output) code matrix into the first rows of the given matrix without allocating memory
+   * (except for other data types than float and double). The values are converted to the data type of the given matrix.
+   */
+  void decodeRows(torch::Tensor const& codes, int64_t const* rows, size_t numberOfRows, bool isOutput, torch::Tensor& values) const;
+
+private:
+  /*
+   * Fixed point encoding of each column: value = code * scale + offset
+   */
+  class FixedPointEncoding
+  {
+  public:
+    std::vector<TensorDataType> scale {};
+    std::vector<TensorDataType> offset {};
+  };
+
+  [[nodiscard]]
+  static FixedPointEncoding CreateEncoding(MinMaxVector const& valueRanges);
+
+private:
+  Format format;
+  FixedPointEncoding inputEncoding {};
+  FixedPointEncoding outputEncoding {};
+};
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Utilities {
+
+/*
+ * Reads a compressed file block by block. The decompression runs on its own thread and fills a fixed number of blocks,
+ * so the memory usage is bounded independent of the file size.
+ */
+class CompressedFileReader
+{
+public:
+  enum class Format
+  {
+    Uncompressed, Gzip, Zstd
+  };
+
+  class Decoder
+  {
+  public:
+    virtual ~Decoder() = default;
+    /*
+     * Decompresses up to capacity bytes to the given buffer and returns the number of written bytes. Returns 0 at the end of the file.
+     * Throws a std::runtime_error if the data cannot be decompressed.
+     */
+    virtual size_t decompress(char* output, size_t capacity) = 0;
+  };
+
+public:
+  /*
+   * Detects the compression format of the given file by its first bytes.
+   */
+  [[nodiscard]]
+  static Format DetectFormat(FilePath const& path);
+  /*
+   * Detects the compression format of the given file content by its first bytes.
+   */
+  [[nodiscard]]
+  static Format DetectFormat(char const* data, size_t size);
+  /*
+   * Returns true if the program was built with support for the given format.
+   */
+  [[nodiscard]]
+  static bool IsSupported(Format format);
+  /*
+   * Returns the name of the given format for messages.
+   */
+  [[nodiscard]]
+  static std::string GetFormatName(Format format);
+
+public:
+  /*
+   * Opens the given file and starts the decompression thread. The format must be supported.
+   */
+  CompressedFileReader(FilePath const& path, Format format);
+  ~CompressedFileReader();
+
+  CompressedFileReader(CompressedFileReader const&) = delete;
+  CompressedFileReader& operator=(CompressedFileReader const&) = delete;
+
+public:
+  /*
+   * Swaps the next decompressed block into the given vector. The previous content of the vector is given back to the decompression thread.
+   * Returns false if the end of the file is reached or an error occurred.
+   */
+  bool readBlock(std::vector<char>& block);
+  /*
+   * Returns the error message if the decompression failed, otherwise an empty string.
+   */
+  [[nodiscard]]
+  std::string getError() const;
+
+private:
+  /*
+   * Main function of the decompression thread.
+   */
+  void decompressFile();
+
+private:
+  std::unique_ptr<Decoder> decoder;
+
+  mutable std::mutex mutex;
+  std::condition_variable blockAvailable;
+  std::deque<std::vector<char>> freeBlocks{};
+  std::deque<std::vector<char>> filledBlocks{};
+  bool endOfFile = false;
+  bool stopRequested = false;
+  std::string error{};
+
+  std::thread decompressionThread;
+};
+
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Utilities/dataset.h"
+
 #include <torch/torch.h>
 #include <vector>
 
@@ -14,8 +16,9 @@ const uint32_t MaxNumberOfNodes = 10000;
 using TensorDataType = double;
 const torch::ScalarType TORCH_DATA_TYPE = torch::kDouble;
 
-using DataVector = std::vector<std::pair<torch::Tensor, torch::Tensor>>;
-using BatchMap = std::unordered_map<std::string, DataVector>;
+using DataPartFunction = std::function<void(Dataset const& part)>;
+using DataPartIterator = std::function<void(DataPartFunction const& function)>; // calls the given function for each part of a dataset
+using BatchVector = std::vector<Dataset>; // batches as consecutive row ranges of one dataset
 using MinMaxVector = std::vector<std::pair<TensorDataType, TensorDataType>>;
 using MinMaxValues = std::pair<MinMaxVector, MinMaxVector>;
 using MixedMinMaxValues = std::pair<MinMaxValues, MinMaxValues>;
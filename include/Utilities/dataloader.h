@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Utilities/constants.h"
+
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+
+namespace Utilities {
+
+/*
+ * Returns the rows of a dataset as batches (matrices [batchSize, numberIn] and [batchSize, numberOut], the last batch may be smaller).
+ * The next batch is gathered on a background thread into one of two preallocated buffers, while the current batch is used.
+ * The order of the rows can be shuffled with the given random number generator.
+ */
+class DataLoader
+{
+public:
+  /*
+   * Starts gathering the first batches of the given data. The data has to outlive the loader.
+   * If a random number generator is given, the rows are shuffled with it, otherwise they are returned in their order.
+   */
+  DataLoader(Dataset const& data, size_t batchSize, std::mt19937_64* randomGenerator = nullptr);
+  ~DataLoader();
+
+  DataLoader(DataLoader const&) = delete;
+  DataLoader& operator=(DataLoader const&) = delete;
+
+  /*
+   * Returns the inputs and outputs of the next batch or nullopt, if all rows were returned.
+   * The returned matrices are views into a buffer, which is reused after the next call.
+   */
+  [[nodiscard]]
+  std::optional<std::pair<torch::Tensor, torch::Tensor>> next();
+
+private:
+  /*
+   * Gathers all batches into the buffers (runs on the background thread).
+   */
+  void gatherBatches();
+
+private:
+  class Buffer
+  {
+  public:
+    torch::Tensor inputs {};
+    torch::Tensor outputs {};
+    int64_t numberOfRows = 0;
+    bool filled = false;
+  };
+
+  static constexpr size_t NUMBER_OF_BUFFERS = 2;
+
+  Dataset const& data;
+  size_t batchSize;
+  size_t numberOfBatches;
+  std::vector<int64_t> order {};
+
+  std::array<Buffer, NUMBER_OF_BUFFERS> buffers {};
+  size_t nextBatch = 0;
+  std::optional<size_t> bufferInUse {};
+  bool stopGathering = false;
+  std::exception_ptr gatheringError {};
+  std::mutex mutex {};
+  std::condition_variable bufferChanged {};
+  std::thread gatheringThread {};
+};
+
+}
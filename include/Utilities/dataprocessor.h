@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Utilities/columnstatistics.h"
 #include "Utilities/constants.h"
 
 namespace Utilities {
@@ -8,13 +9,26 @@ class DataProcessor
 {
 public:
   /*
-   * Calculates the minimum and maximum values from the given data.
+   * Calculates the statistics (min, max, mean, variance) of each column of the given data in a single pass. The rows are split across the given
+   * number of threads, the partial statistics of the threads are merged afterwards.
    */
-  static void CalculateMinMax(DataVector const& data, MinMaxValues& minMaxVectors);
+  [[nodiscard]]
+  static DatasetStatistics CalculateStatistics(Dataset const& data, uint32_t numberOfThreads = 1);
+  /*
+   * Calculates the statistics of the given data with respect to an active mixed scaling in a single pass: the output rows are assigned
+   * to one of the two regions with a mask of the threshold variable.
+   */
+  [[nodiscard]]
+  static MixedDatasetStatistics CalculateMixedStatistics(Dataset const& data, uint32_t thresholdVariable, TensorDataType threshold, uint32_t numberOfThreads = 1);
+  /*
+   * Calculates the minimum and maximum values of each column of the given data.
+   */
+  static void CalculateMinMax(Dataset const& data, MinMaxValues& minMaxVectors, uint32_t numberOfThreads = 1);
   /*
    * Calculates the minimum and maximum values from the given data with respect to an active mixed scaling.
    */
-  static void CalculateMixedMinMax(DataVector const& data, uint32_t thresholdVariable, TensorDataType threshold, MixedMinMaxValues& mixedMinMaxValues);
+  static void CalculateMixedMinMax(Dataset const& data, uint32_t thresholdVariable, TensorDataType threshold, MixedMinMaxValues& mixedMinMaxValues,
+                                   uint32_t numberOfThreads = 1);
   /*
    * Parses and returns the minimum and maximum values from the given file.
    */
@@ -27,9 +41,10 @@ public:
   static std::optional<MixedMinMaxValues> GetMixedMinMaxFromFile(FilePath const& filePath, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables);
 
   /*
-   * Normalizes all given tensors.
+   * Normalizes all rows of the given data in place. The rows are split across the given number of threads.
    */
-  static void Normalize(DataVector& data, std::pair<MinMaxVector const, MinMaxVector const> const& minMaxVectors, TensorDataType newMinValue = -0.5, TensorDataType newMaxValue = 0.5);
+  static void Normalize(Dataset& data, std::pair<MinMaxVector const, MinMaxVector const> const& minMaxVectors, TensorDataType newMinValue = -0.5, TensorDataType newMaxValue = 0.5,
+                        uint32_t numberOfThreads = 1);
   /*
    * Normalizes the given tensor.
    */
@@ -56,6 +71,19 @@ public:
    * Reverts the scaling with the square root function.
    */
   static void UnscaleSquareRoot(torch::Tensor& data);
+
+  /*
+   * Whole-matrix versions of the functions above. The matrix [N, C] is transformed in place in one pass over its raw buffer, a single row [C] counts as a matrix with one row.
+   * The rows are split across the given number of threads. The (de)normalization uses the min/max values of each column and does nothing if their number does not match C.
+   */
+  static void NormalizeMatrix(torch::Tensor& matrix, MinMaxVector const& minMaxVector, TensorDataType newMinValue = -0.5, TensorDataType newMaxValue = 0.5,
+                              uint32_t numberOfThreads = 1);
+  static void DenormalizeMatrix(torch::Tensor& matrix, MinMaxVector const& minMaxVector, TensorDataType oldMinValue = -0.5, TensorDataType oldMaxValue = 0.5,
+                                bool limitValues = false, uint32_t numberOfThreads = 1);
+  static void ScaleLogarithmicMatrix(torch::Tensor& matrix, uint32_t numberOfThreads = 1);
+  static void UnscaleLogarithmicMatrix(torch::Tensor& matrix, uint32_t numberOfThreads = 1);
+  static void ScaleSquareRootMatrix(torch::Tensor& matrix, uint32_t numberOfThreads = 1);
+  static void UnscaleSquareRootMatrix(torch::Tensor& matrix, uint32_t numberOfThreads = 1);
 };
 
 }
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <torch/torch.h>
+
+#include <memory>
+#include <vector>
+
+namespace Utilities {
+class CompactEncoding;
+}
+
+/*
+ * Data points stored as two contiguous matrices: inputs [N, numberIn] and outputs [N, numberOut].
+ * A row is returned as a view into the matrices, so no memory is allocated per data point.
+ * A subset refers to rows of the matrices via indices and shares the memory of the dataset it was created from.
+ * A compact dataset (see compact) stores the codes of a CompactEncoding in its matrices. Its rows and matrices are decoded into new tensors,
+ * so changes to them do not change the dataset.
+ */
+class Dataset
+{
+public:
+  /*
+   * Iterates over the rows of a dataset. Dereferencing returns the views of the input and output values of the current row.
+   */
+  class Iterator
+  {
+  public:
+    Iterator(Dataset const& dataset, size_t row) : dataset(dataset), row(row) {}
+
+    std::pair<torch::Tensor, torch::Tensor> operator*() const { return dataset[row]; }
+    Iterator& operator++() { ++row; return *this; }
+    bool operator!=(Iterator const& other) const { return row != other.row; }
+
+  private:
+    Dataset const& dataset;
+    size_t row;
+  };
+
+  /*
+   * Creates an empty dataset without any columns.
+   */
+  Dataset() = default;
+  /*
+   * Creates a dataset from an input matrix [N, numberIn] and an output matrix [N, numberOut]. The matrices are not copied.
+   */
+  Dataset(torch::Tensor inputs, torch::Tensor outputs);
+  /*
+   * Creates a compact dataset with the given number of rows and columns, whose values are set later (e.g. chunk by chunk via slice and setInputs).
+   * The values are decoded to the given data type.
+   */
+  [[nodiscard]]
+  static Dataset CreateCompact(int64_t numberOfRows, int64_t numberOfInputs, int64_t numberOfOutputs,
+                               std::shared_ptr<Utilities::CompactEncoding const> encoding, torch::ScalarType dataType);
+
+  [[nodiscard]]
+  size_t size() const;
+  [[nodiscard]]
+  bool empty() const;
+  [[nodiscard]]
+  int64_t getNumberOfInputVariables() const;
+  [[nodiscard]]
+  int64_t getNumberOfOutputVariables() const;
+
+  /*
+   * Returns views of the input/output values of the given row. Changes to the views change the dataset (except for a compact dataset).
+   */
+  [[nodiscard]]
+  torch::Tensor input(size_t row) const;
+  [[nodiscard]]
+  torch::Tensor output(size_t row) const;
+  [[nodiscard]]
+  std::pair<torch::Tensor, torch::Tensor> operator[](size_t row) const;
+
+  /*
+   * Returns the input/output matrix. The matrices of a subset are gathered into new matrices, otherwise they share the memory of the dataset.
+   */
+  [[nodiscard]]
+  torch::Tensor inputs() const;
+  [[nodiscard]]
+  torch::Tensor outputs() const;
+  /*
+   * Writes the given matrix [size(), numberIn/numberOut] to the rows of the dataset (and of the dataset the subset was created from).
+   * The values are encoded, if the dataset is compact.
+   */
+  void setInputs(torch::Tensor const& values);
+  void setOutputs(torch::Tensor const& values);
+
+  /*
+   * Copies the given rows (indices relative to this dataset) into the first rows of the given matrices without allocating memory.
+   * The matrices need the data type of the dataset and at least numberOfRows rows. The rows of a compact dataset are decoded into the matrices.
+   */
+  void gatherRows(int64_t const* rows, size_t numberOfRows, torch::Tensor& inputs, torch::Tensor& outputs) const;
+  /*
+   * Returns the subset with the given rows (indices relative to this dataset) without copying the data.
+   */
+  [[nodiscard]]
+  Dataset subset(std::vector<int64_t> const& rows) const;
+  /*
+   * Returns the rows [begin, end) without copying the data.
+   */
+  [[nodiscard]]
+  Dataset slice(size_t begin, size_t end) const;
+  /*
+   * Returns true, if the dataset refers to its rows via indices.
+   */
+  [[nodiscard]]
+  bool isSubset() const;
+  /*
+   * Returns a new compact dataset with the rows of this dataset encoded by the given encoding, whose values are decoded to the given data type.
+   * Throws a std::runtime_error, if a value cannot be encoded.
+   */
+  [[nodiscard]]
+  Dataset compact(std::shared_ptr<Utilities::CompactEncoding const> encoding, torch::ScalarType dataType) const;
+  /*
+   * Returns true, if the matrices of the dataset store encoded values.
+   */
+  [[nodiscard]]
+  bool isCompact() const;
+  /*
+   * Returns the data type of the values of the dataset (the data type of the decoded values of a compact dataset).
+   */
+  [[nodiscard]]
+  torch::ScalarType getDataType() const;
+  /*
+   * Returns the dataset with matrices of the given data type. The matrices are only copied, if they have another data type.
+   * The row indices of a subset are kept, so the subset refers to the converted matrices.
+   * The codes of a compact dataset are kept and decoded to the given data type.
+   */
+  [[nodiscard]]
+  Dataset to(torch::ScalarType dataType) const;
+  /*
+   * Returns the dataset with row-major contiguous matrices. The matrices are only copied, if they have another layout (e.g. column-major views of a
+   * binary dataset file). The row indices of a subset are kept.
+   */
+  [[nodiscard]]
+  Dataset contiguous() const;
+  /*
+   * Returns a copy of the dataset with row-major contiguous matrices, which never share memory with this dataset (e.g. to change the values of
+   * a read-only binary dataset file). The row indices of a subset are kept.
+   */
+  [[nodiscard]]
+  Dataset clone() const;
+
+  [[nodiscard]]
+  Iterator begin() const;
+  [[nodiscard]]
+  Iterator end() const;
+
+private:
+  [[nodiscard]]
+  int64_t getMatrixRow(size_t row) const;
+  [[nodiscard]]
+  torch::Tensor getRowIndexTensor() const;
+  [[nodiscard]]
+  torch::Tensor decode(torch::Tensor const& codes, bool isOutput) const;
+  [[nodiscard]]
+  Dataset withMatrices(torch::Tensor inputs, torch::Tensor outputs) const;
+
+private:
+  torch::Tensor inputMatrix {};
+  torch::Tensor outputMatrix {};
+  std::shared_ptr<std::vector<int64_t> const> rowIndices {nullptr}; // nullptr if the dataset contains all rows of the matrices
+  std::shared_ptr<Utilities::CompactEncoding const> encoding {nullptr}; // nullptr if the matrices store the values
+  torch::ScalarType valueType = torch::kDouble; // data type of the decoded values of a compact dataset
+};
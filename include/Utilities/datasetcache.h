@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Utilities/constants.h"
+#include "Utilities/programoptions.h"
+#include "Utilities/transformpipeline.h"
+
+#include <optional>
+
+namespace Utilities {
+
+/*
+ * The result of the preprocessing phase (scaling, min/max calculation and normalization) and the transform pipeline which was used for it.
+ */
+class PreprocessedDataset
+{
+public:
+  Dataset data;
+  std::string fileHeader;
+  TransformPipeline pipeline;
+};
+
+/*
+ * On-disk cache for preprocessed datasets. An entry is identified by a hash of the input file content and of all options which influence
+ * the preprocessing. There is at most one entry per input file path, an outdated entry is replaced when a new one is stored.
+ */
+class DatasetCache
+{
+public:
+  /*
+   * Creates a cache in the given directory for the input file and the preprocessing options of the given program options.
+   * The input file (and the min/max or pipeline file, if set) is hashed in the constructor.
+   */
+  explicit DatasetCache(FilePath directory, ProgramOptions const& options);
+
+public:
+  /*
+   * Returns the cached dataset if a valid entry exists for the current input file and options.
+   */
+  [[nodiscard]]
+  std::optional<PreprocessedDataset> load() const;
+  /*
+   * Stores the given dataset and removes outdated entries of the same input file.
+   */
+  void store(PreprocessedDataset const& dataset) const;
+
+private:
+  FilePath directory;
+  std::string entryPrefix;
+  std::string entryName;
+  std::vector<int64_t> key;
+};
+
+}
@@ -8,20 +8,32 @@ class DataSplitter
 {
 public:
   /*
-   * Splits the data randomly into two vectors with the given probability.
+   * Splits the data randomly into two subsets with the given probability. The same seed results in the same split of the same data.
    */
   [[nodiscard]]
-  static std::pair<DataVector, DataVector> splitDataRandomly(DataVector const& inputData, double trainingPercentage);
+  static std::pair<Dataset, Dataset> splitDataRandomly(Dataset const& inputData, double trainingPercentage, uint64_t seed);
   /*
-   * Splits the data into two vectors with the given threshold.
+   * Returns for each row of data with the given number of rows, whether splitDataRandomly puts it into the training data (one bit per row).
    */
   [[nodiscard]]
-  static std::pair<DataVector, DataVector> splitDataWithThreshold(DataVector const& data, uint32_t thresholdVariable, TensorDataType threshold);
+  static std::vector<bool> getTrainingRowsRandomly(uint64_t numberOfRows, double trainingPercentage, uint64_t seed);
   /*
-   * Splits the data into batches with the given batch variable.
+   * Splits a part of the data, which starts at firstRow of the whole data, like the given training rows of the whole data (see getTrainingRowsRandomly),
+   * so that a dataset which is split part by part is split the same way as with splitDataRandomly.
    */
   [[nodiscard]]
-  static BatchMap splitDataIntoBatches(DataVector const& data, uint32_t batchVariable);
+  static std::pair<Dataset, Dataset> splitDataWithTrainingRows(Dataset const& data, uint64_t firstRow, std::vector<bool> const& trainingRows);
+  /*
+   * Splits the data into two subsets with the given threshold.
+   */
+  [[nodiscard]]
+  static std::pair<Dataset, Dataset> splitDataWithThreshold(Dataset const& data, uint32_t thresholdVariable, TensorDataType threshold);
+  /*
+   * Splits the data into batches with the given batch variable: the rows of a batch have exactly the same values in all other input columns.
+   * The rows are copied into a new dataset ordered by batch, so that each batch is a slice of consecutive rows (in the order of their first occurrence).
+   */
+  [[nodiscard]]
+  static BatchVector splitDataIntoBatches(Dataset const& data, uint32_t batchVariable);
 };
 
 }
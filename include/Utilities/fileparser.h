@@ -1,7 +1,10 @@
 #pragma once
 
+#include "Utilities/columnstatistics.h"
 #include "Utilities/constants.h"
 
+#include <functional>
+#include <limits>
 #include <optional>
 
 namespace Utilities {
@@ -10,13 +13,43 @@ class FileParser
 {
 public:
   /*
-   * Parses the given file and returns the data and the file header.
+   * Function which is called for each chunk of a file. Gets the chunk, its statistics (collected while it is parsed), the index of its first row
+   * and the number of rows of the whole file. Returning false stops the parsing.
    */
-  static std::optional<DataVector> ParseInputFile(std::string const& path, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes, std::string& fileHeader);
+  using ChunkFunction = std::function<bool(Dataset const& chunk, DatasetStatistics const& statistics, uint64_t firstRow, uint64_t numberOfRows)>;
+  static constexpr uint64_t UNLIMITED_ROWS_PER_CHUNK = std::numeric_limits<uint64_t>::max();
+
+  /*
+   * Parses the given file and returns the data and the file header. The data is stored in two contiguous matrices (inputs and outputs).
+   * The file is split into line aligned parts, which are parsed in parallel with the given number of threads. The order of the rows is preserved.
+   * The path can also be a directory or a glob pattern (see GetInputFilePaths). All files must have the same header, they are parsed in parallel
+   * (one file per thread) and the rows are concatenated in the order of the file names.
+   * A single input file can also be compressed (gzip or zstd). It is decompressed on another thread while it is parsed.
+   * If statistics is given, the statistics of the columns are collected while the file is parsed (no second pass over the data).
+   */
+  static std::optional<Dataset> ParseInputFile(std::string const& path, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes, std::string& fileHeader,
+                                               uint32_t numberOfThreads = 1, DatasetStatistics* statistics = nullptr);
+  /*
+   * Parses the given file like ParseInputFile, but passes the data chunk by chunk (in the order of the rows) to the given function.
+   * A chunk contains at most the given number of rows, unless a single part of the file (up to 16 MiB) contains more rows. Only the current chunk is kept in memory.
+   * Compressed files can only be parsed with an unlimited number of rows per chunk.
+   * Returns the number of rows of the whole file.
+   */
+  static std::optional<uint64_t> ParseInputFileInChunks(std::string const& path, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes, std::string& fileHeader,
+                                                        uint32_t numberOfThreads, uint64_t maximumRowsPerChunk, ChunkFunction const& function);
+  /*
+   * Returns the files which belong to the given input path, sorted by name:
+   * - for a directory: all regular files in it (except hidden files)
+   * - for a glob pattern (e.g. "parts/shard_*.csv"): all regular files matching the pattern
+   * - otherwise: the path itself
+   */
+  [[nodiscard]]
+  static std::vector<FilePath> GetInputFilePaths(std::string const& path);
   /*
    * Saves the data to given file path together with the given file header.
+   * If append is true, the data is appended to the file without the file header.
    */
-  static void SaveData(DataVector const& data, std::string const& outputFilePath, std::string const& fileHeader);
+  static void SaveData(Dataset const& data, std::string const& outputFilePath, std::string const& fileHeader, bool append = false);
   /*
    * Saves the given progress data to the given file path.
    */
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Utilities {
+
+class MappedFile
+{
+public:
+  /*
+   * Maps the given file read-only into memory. If the file cannot be opened or mapped, isOpen() returns false.
+   */
+  explicit MappedFile(std::string const& path);
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+public:
+  /*
+   * Returns true if the file was opened successfully. An empty file counts as opened, but has no data.
+   */
+  [[nodiscard]]
+  bool isOpen() const { return opened; }
+  /*
+   * Returns the first byte of the mapped file or nullptr if the file is empty.
+   */
+  [[nodiscard]]
+  char const* data() const { return begin; }
+  /*
+   * Returns the size of the mapped file in bytes.
+   */
+  [[nodiscard]]
+  size_t size() const { return length; }
+
+private:
+  /*
+   * Unmaps the file (if mapped) and resets all members.
+   */
+  void close();
+
+private:
+  char const* begin = nullptr;
+  size_t length = 0;
+  bool opened = false;
+};
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Utilities {
+
+/*
+ * Calls the given function for all indices in [0, numberOfTasks). The tasks are distributed dynamically to (at most) the given number of threads.
+ * A single task is executed on the calling thread without starting any threads.
+ */
+template<class Function>
+void runInParallel(size_t numberOfTasks, uint32_t numberOfThreads, Function const& function)
+{
+  std::atomic<size_t> nextTask = 0;
+  auto worker = [&nextTask, numberOfTasks, &function]() {
+    for (auto task = nextTask++; task < numberOfTasks; task = nextTask++) {
+      function(task);
+    }
+  };
+
+  auto numberOfWorkers = std::min<size_t>(numberOfTasks, std::max(numberOfThreads, 1u));
+  std::vector<std::thread> threads{};
+  for (size_t i = 1; i < numberOfWorkers; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}
@@ -5,10 +5,21 @@
 #include <map>
 #include <string>
 
+#include "Utilities/compactencoding.h"
 #include "Utilities/constants.h"
 
 namespace Utilities {
 
+enum class OptimizerType : uint8_t
+{
+  SGD, Adam, AdamW, RMSprop, LBFGS, LevenbergMarquardt
+};
+
+enum class LearnRateScheduleType : uint8_t
+{
+  Constant, Step, Cosine, OneCycle, ReduceOnPlateau
+};
+
 namespace DefaultValues {
 
 const FilePath                INPUT_DATA_FILE_PATH = {};
@@ -44,11 +55,36 @@ const uint32_t                NUMBER_OF_LAYERS = 2;
 const uint32_t                NUMBER_OF_NODES_PER_LAYER = 500;
 const std::optional<uint32_t> BATCH_TRAINING_INPUT_VARIABLE = std::nullopt;
 const bool                    DEBUG_OUTPUT = false;
+const FilePath                CONVERT_INPUT_FILE_PATH = {};
+const FilePath                CACHE_DIRECTORY = {};
+const std::optional<uint64_t> MEMORY_LIMIT_IN_MB = std::nullopt;
+const FilePath                INPUT_PIPELINE_FILE_PATH = {};
+const FilePath                OUTPUT_PIPELINE_FILE_PATH = {};
+const torch::ScalarType       PRECISION = torch::kDouble;
+const std::optional<CompactEncoding::Format> COMPACT_STORAGE_FORMAT = std::nullopt;
+const uint32_t                BATCH_SIZE = 1;
+const bool                    SHUFFLE_DATA = false;
+const OptimizerType           OPTIMIZER = OptimizerType::SGD;
+const double                  MOMENTUM = 0.0;
+const bool                    NESTEROV = false;
+const double                  WEIGHT_DECAY = 0.0;
+const LearnRateScheduleType   LEARN_RATE_SCHEDULE = LearnRateScheduleType::Constant;
+const uint32_t                LEARN_RATE_STEP_EPOCHS = 100;
+const double                  LEARN_RATE_FACTOR = 0.1;
+const uint32_t                EVALUATION_INTERVAL = 0;
+const uint64_t                EVALUATION_SAMPLE_SIZE = 0;
+const uint32_t                VALIDATION_INTERVAL = 0;
+const uint32_t                VALIDATION_PATIENCE = 3;
+const FilePath                CHECKPOINT_FILE_PATH = {};
+const uint32_t                CHECKPOINT_INTERVAL = 0;
+const FilePath                RESUME_FILE_PATH = {};
+const uint32_t                DATA_PARALLEL_WORKERS = 1;
+const uint32_t                HOGWILD_THREADS = 1;
 
 const std::string CLI_HELP_TEXT = {
   std::string("List of possible commandline parameters:\n") +
   "--help | -h                        : Output this text message.\n" +
-  "--input <filepath> | -i <filepath> : Use content of <filepath> for the input data.\n" +
+  "--input <filepath> | -i <filepath> : Use content of <filepath> for the input data. <filepath> can also be a directory or a glob pattern (e.g. \"parts/shard_*.csv\") of files with the same header. A single input file can be compressed with gzip or zstd.\n" +
   "--numberIn X | -ni X               : Sets the number of input variables to X. Default: " + std::to_string(NUMBER_OF_INPUT_VARIABLES) + "\n" +
   "--numberOut X | -no X              : Sets the number of output variables to X. Default: " + std::to_string(NUMBER_OF_OUTPUT_VARIABLES) + "\n" +
   "--epochs X | -e X                  : Sets the minimum number of epochs (how many times the data is used for training). Default: " + std::to_string(NUMBER_OF_EPOCHS) + "\n" +
@@ -75,11 +111,48 @@ const std::string CLI_HELP_TEXT = {
   "--timeoutInHours X                 : Sets the timeout of the program to X hours. Default: 1 week.\n" +
   "--numberOfDeteriorations X         : Sets the number of epochs in a row in which the improvement can be worse than the set epsilon without stopping. Default: " + std::to_string(NUMBER_OF_DETERIORATIONS) + "\n" +
   "--saveProgress <filepath>          : If set, saves the progress in a CSV file at the specified path.\n" +
-  "--seed <uint64>                    : Sets the seed of the random number generator, which is used for initializing the network parameters.\n" +
+  "--seed <uint64>                    : Sets the seed of the random number generator, which is used for initializing the network parameters and for splitting the validation data.\n" +
   "--layers X                         : Sets the number of layers of the NN to X. Default: " + std::to_string(NUMBER_OF_LAYERS) + "\n" +
   "--nodes X                          : Sets the number of nodes per layer of the NN to X. Default: " + std::to_string(NUMBER_OF_NODES_PER_LAYER) + "\n" +
   "--batchVariable X                  : If set, concatenates training data around input variable X [1, ..] to batches.\n" +
-  "--debugOutput                      : If set, some debug information gets outputted to the console.\n"
+  "--debugOutput                      : If set, some debug information gets outputted to the console.\n" +
+  "--convertInput <filepath>          : If set, converts the input file to the binary dataset format, saves it to <filepath> and exits. Binary dataset files can be used with --input.\n" +
+  "--cacheDirectory <path>            : If set, caches the preprocessed (scaled and normalized) data in the given directory to skip the preprocessing in later runs. Not used with --resume.\n" +
+  "--memoryLimit X                    : If set, keeps at most X MiB of the data in memory. The input must be a binary dataset file (see --convertInput), which is streamed from disk in chunks. The data is normalized once into a temporary file of the same size (in the cache directory or the temporary directory). Also limits the memory usage of --convertInput.\n" +
+  "--inPipeline <filepath>            : If set, loads the transform pipeline (scaling and normalization) from the given file instead of calculating the min/max values.\n" +
+  "--outPipeline <filepath>           : If set, saves the used transform pipeline (scaling and normalization) to the given file.\n" +
+  "--precision <type>                 : Sets the data type of the training data and the network: float64, float32 or bfloat16 (data stored as bfloat16, network computed in float32). The evaluation and the output files always use float64 values. Default: float64\n" +
+  "--compactStorage <format>          : If set, keeps the preprocessed data in memory with 2 bytes per value: float16 or fixed16 (16-bit fixed point relative to the normalized range of each column). The rows are decoded batch by batch during the training, the output files and the behaviour use the exact data, which is read again after the training. Not finite values are rejected.\n" +
+  "--batchSize X                      : Sets the number of data points which are used together for one step of the optimizer. Default: " + std::to_string(BATCH_SIZE) + "\n" +
+  "--shuffle                          : If set, shuffles the order of the training data in each epoch (with the seed of --seed, if set). The batches are gathered on a background thread.\n" +
+  "--optimizer <type>                 : Sets the optimizer: sgd, adam, adamw, rmsprop or lbfgs (full-batch L-BFGS with strong Wolfe line search, one step per epoch, " +
+                                       "the learning rate is the initial step length, typically 1) or lm (Levenberg-Marquardt with all training data, one step per epoch, " +
+                                       "only for small networks, see --layers and --nodes). Default: sgd\n" +
+  "--momentum X                       : Sets the momentum of the optimizer sgd or rmsprop. Default: " + std::to_string(MOMENTUM) + "\n" +
+  "--nesterov                         : If set, the optimizer sgd uses Nesterov momentum (needs --momentum > 0).\n" +
+  "--weightDecay X                    : Sets the weight decay of the optimizer (decoupled from the gradient for adamw). Default: " + std::to_string(WEIGHT_DECAY) + "\n" +
+  "--lrSchedule <type>                : Sets the schedule of the learning rate per epoch: constant, step (multiplied by --lrFactor every --lrStepEpochs epochs), " +
+                                       "cosine (annealed over the set number of epochs), onecycle (warm-up and annealing over the set number of epochs) or " +
+                                       "plateau (multiplied by --lrFactor, if the error did not improve by epsilon for more than --numberOfDeteriorations epochs). Default: constant\n" +
+  "--lrStepEpochs X                   : Sets the number of epochs after which the step schedule reduces the learning rate. Default: " + std::to_string(LEARN_RATE_STEP_EPOCHS) + "\n" +
+  "--lrFactor X                       : Sets the factor which the step and plateau schedule apply to the learning rate. Default: " + std::to_string(LEARN_RATE_FACTOR) + "\n" +
+  "--evalEvery N                      : If set, the mean squared error (stopping criterion and progress) is calculated exactly with the trained network after every N-th epoch. " +
+                                       "Otherwise the errors accumulated during the previous training pass are used.\n" +
+  "--evalSample K                     : If set, the exact calculation of the mean squared error (first epoch and --evalEvery) only uses K evenly spaced rows of the training data.\n" +
+  "--validateEvery K                  : If set (with --validate), the validation data is evaluated on a separate thread every K epochs while the training continues. " +
+                                       "The training stops early, if the validation error does not improve anymore, and the parameters with the lowest validation error are used afterwards.\n" +
+  "--validationPatience X             : Sets the number of validations in a row without improvement, after which the training stops (see --validateEvery). Default: " + std::to_string(VALIDATION_PATIENCE) + "\n" +
+  "--checkpoint <filepath>            : Sets the file to which the checkpoints are written (see --checkpointEvery).\n" +
+  "--checkpointEvery N                : If set (with --checkpoint), saves the complete state of the training (network, optimizer, epoch, progress, transform pipeline, ...) " +
+                                       "after every N-th epoch. The file is written on a background thread, while the training continues.\n" +
+  "--resume <filepath>                : If set, continues the training from the given checkpoint (see --checkpointEvery). " +
+                                       "The other options have to be the same as for the training which created the checkpoint.\n" +
+  "--dataParallel N                   : Sets the number of threads which compute the gradients of a batch together, each with its own copy of the network " +
+                                       "(only for batches of several rows, see --batchSize and --batchVariable). The gradients are summed, so each batch has a single optimizer step as with one thread. " +
+                                       "Should be used with --threads 1. Default: " + std::to_string(DATA_PARALLEL_WORKERS) + "\n" +
+  "--hogwild N                        : Sets the number of threads which train row by row (--batchSize 1) at the same time without locks (Hogwild). " +
+                                       "Each thread trains with its own part of the data and its own optimizer and updates the shared network parameters. " +
+                                       "The result is not deterministic. The throughput of each thread is shown after the training. Should be used with --threads 1. Default: " + std::to_string(HOGWILD_THREADS) + "\n"
 };
 
 }
@@ -89,7 +162,11 @@ enum class CLIParameters
   Help, InputFilePath, NumberOfInputVariables, NumberOfOutputVariables, NumberOfEpochs, ShowProgressDuringTraining, InputNetworkParameters,
   OutputNetworkParameters, Interactive, Epsilon, LogScaling, SqrtScaling, LogLinScaling, LogSqrtScaling, Validate, ValidatePercentage, OutValues,
   OutDiff, OutRelativeDiff, PrintBehaviour, Threads, InputMinMax, OutputMinMax, LearnRate, TimeoutMinutes, TimeoutHours, NumberOfDeteriorations,
-  SaveProgress, Seed, NumberOfLayers, NumberOfNodes, BatchVariable, DebugOutput
+  SaveProgress, Seed, NumberOfLayers, NumberOfNodes, BatchVariable, DebugOutput, ConvertInput,
+  CacheDirectory, MemoryLimit, InputPipeline, OutputPipeline, Precision, CompactStorage, BatchSize, Shuffle,
+  Optimizer, Momentum, Nesterov, WeightDecay, LearnRateSchedule, LearnRateStepEpochs, LearnRateFactor,
+  EvaluationInterval, EvaluationSampleSize, ValidationInterval, ValidationPatience, Checkpoint, CheckpointInterval, Resume,
+  DataParallelWorkers, HogwildThreads
 };
 
 const std::map<std::string, CLIParameters> CLIParameterMap {
@@ -131,7 +208,60 @@ const std::map<std::string, CLIParameters> CLIParameterMap {
   {"--layers",                CLIParameters::NumberOfLayers},
   {"--nodes",                 CLIParameters::NumberOfNodes},
   {"--batchVariable",         CLIParameters::BatchVariable},
-  {"--debugOutput",           CLIParameters::DebugOutput}
+  {"--debugOutput",           CLIParameters::DebugOutput},
+  {"--convertInput",          CLIParameters::ConvertInput},
+  {"--cacheDirectory",        CLIParameters::CacheDirectory},
+  {"--memoryLimit",           CLIParameters::MemoryLimit},
+  {"--inPipeline",            CLIParameters::InputPipeline},
+  {"--outPipeline",           CLIParameters::OutputPipeline},
+  {"--precision",             CLIParameters::Precision},
+  {"--compactStorage",        CLIParameters::CompactStorage},
+  {"--batchSize",             CLIParameters::BatchSize},
+  {"--shuffle",               CLIParameters::Shuffle},
+  {"--optimizer",             CLIParameters::Optimizer},
+  {"--momentum",              CLIParameters::Momentum},
+  {"--nesterov",              CLIParameters::Nesterov},
+  {"--weightDecay",           CLIParameters::WeightDecay},
+  {"--lrSchedule",            CLIParameters::LearnRateSchedule},
+  {"--lrStepEpochs",          CLIParameters::LearnRateStepEpochs},
+  {"--lrFactor",              CLIParameters::LearnRateFactor},
+  {"--evalEvery",             CLIParameters::EvaluationInterval},
+  {"--evalSample",            CLIParameters::EvaluationSampleSize},
+  {"--validateEvery",         CLIParameters::ValidationInterval},
+  {"--validationPatience",    CLIParameters::ValidationPatience},
+  {"--checkpoint",            CLIParameters::Checkpoint},
+  {"--checkpointEvery",       CLIParameters::CheckpointInterval},
+  {"--resume",                CLIParameters::Resume},
+  {"--dataParallel",          CLIParameters::DataParallelWorkers},
+  {"--hogwild",               CLIParameters::HogwildThreads}
+};
+
+const std::map<std::string, torch::ScalarType> PrecisionMap {
+  {"float64",                 torch::kDouble},
+  {"float32",                 torch::kFloat},
+  {"bfloat16",                torch::kBFloat16}
+};
+
+const std::map<std::string, CompactEncoding::Format> CompactStorageFormatMap {
+  {"float16",                 CompactEncoding::Format::Float16},
+  {"fixed16",                 CompactEncoding::Format::Fixed16}
+};
+
+const std::map<std::string, OptimizerType> OptimizerTypeMap {
+  {"sgd",                     OptimizerType::SGD},
+  {"adam",                    OptimizerType::Adam},
+  {"adamw",                   OptimizerType::AdamW},
+  {"rmsprop",                 OptimizerType::RMSprop},
+  {"lbfgs",                   OptimizerType::LBFGS},
+  {"lm",                      OptimizerType::LevenbergMarquardt}
+};
+
+const std::map<std::string, LearnRateScheduleType> LearnRateScheduleMap {
+  {"constant",                LearnRateScheduleType::Constant},
+  {"step",                    LearnRateScheduleType::Step},
+  {"cosine",                  LearnRateScheduleType::Cosine},
+  {"onecycle",                LearnRateScheduleType::OneCycle},
+  {"plateau",                 LearnRateScheduleType::ReduceOnPlateau}
 };
 
 class ProgramOptions
@@ -170,6 +300,31 @@ public:
   uint32_t                NumberOfNodesPerLayer {      DefaultValues::NUMBER_OF_NODES_PER_LAYER };
   std::optional<uint32_t> BatchVariable {              DefaultValues::BATCH_TRAINING_INPUT_VARIABLE };
   bool                    DebugOutput {                DefaultValues::DEBUG_OUTPUT };
+  FilePath                ConvertInputFilePath {       DefaultValues::CONVERT_INPUT_FILE_PATH };
+  FilePath                CacheDirectory {             DefaultValues::CACHE_DIRECTORY };
+  std::optional<uint64_t> MemoryLimitInMB {            DefaultValues::MEMORY_LIMIT_IN_MB };
+  FilePath                InputPipelineFilePath {      DefaultValues::INPUT_PIPELINE_FILE_PATH };
+  FilePath                OutputPipelineFilePath {     DefaultValues::OUTPUT_PIPELINE_FILE_PATH };
+  torch::ScalarType       Precision {                  DefaultValues::PRECISION };
+  std::optional<CompactEncoding::Format> CompactStorageFormat { DefaultValues::COMPACT_STORAGE_FORMAT };
+  uint32_t                BatchSize {                  DefaultValues::BATCH_SIZE };
+  bool                    ShuffleData {                DefaultValues::SHUFFLE_DATA };
+  OptimizerType           Optimizer {                  DefaultValues::OPTIMIZER };
+  double                  Momentum {                   DefaultValues::MOMENTUM };
+  bool                    Nesterov {                   DefaultValues::NESTEROV };
+  double                  WeightDecay {                DefaultValues::WEIGHT_DECAY };
+  LearnRateScheduleType   LearnRateSchedule {          DefaultValues::LEARN_RATE_SCHEDULE };
+  uint32_t                LearnRateStepEpochs {        DefaultValues::LEARN_RATE_STEP_EPOCHS };
+  double                  LearnRateFactor {            DefaultValues::LEARN_RATE_FACTOR };
+  uint32_t                EvaluationInterval {         DefaultValues::EVALUATION_INTERVAL };
+  uint64_t                EvaluationSampleSize {       DefaultValues::EVALUATION_SAMPLE_SIZE };
+  uint32_t                ValidationInterval {         DefaultValues::VALIDATION_INTERVAL };
+  uint32_t                ValidationPatience {         DefaultValues::VALIDATION_PATIENCE };
+  FilePath                CheckpointFilePath {         DefaultValues::CHECKPOINT_FILE_PATH };
+  uint32_t                CheckpointInterval {         DefaultValues::CHECKPOINT_INTERVAL };
+  FilePath                ResumeFilePath {             DefaultValues::RESUME_FILE_PATH };
+  uint32_t                DataParallelWorkers {        DefaultValues::DATA_PARALLEL_WORKERS };
+  uint32_t                HogwildThreads {             DefaultValues::HOGWILD_THREADS };
 };
 
 }
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Utilities/constants.h"
+#include "Utilities/programoptions.h"
+
+#include <array>
+#include <optional>
+
+namespace Utilities {
+
+/*
+ * Transforms the data between the original values and the values which are used by the neural network. The pipeline is built once from the
+ * scaling options and the min/max values:
+ * - forward: scaling of the output values (logarithmic or square root, depending on the region of a mixed scaling) and normalization of all values
+ * - inverse: denormalization of all values and unscaling of the output values
+ * The normalization of each column is precomputed as affine transformation (value * scale + offset) and fused with the scaling into a single pass
+ * over whole matrices [N, C]. A single row [C] counts as a matrix with one row. The rows are split across the given number of threads.
+ * With a mixed scaling, the region of each row is calculated as mask for a block of rows and both regions are selected with it instead of branching per row.
+ */
+class TransformPipeline
+{
+public:
+  /*
+   * Creates a pipeline, which neither scales nor normalizes.
+   */
+  TransformPipeline() = default;
+  /*
+   * Creates a pipeline for the scaling options of the given program options. The normalization is added with setMinMax or setMixedMinMax.
+   */
+  explicit TransformPipeline(ProgramOptions const& options);
+
+  /*
+   * Precomputes the normalization from the min/max values of the (scaled) data. All values are normalized to [0, 1].
+   */
+  void setMinMax(MinMaxValues const& minMax);
+  /*
+   * Precomputes the normalization for an active mixed scaling. Output values are normalized to [-1, 0] if the threshold variable is below or equal
+   * to the threshold and to [0, 1] otherwise. Input values are normalized to [0, 1] with the input min/max values of the first region.
+   */
+  void setMixedMinMax(MixedMinMaxValues const& mixedMinMax);
+
+  [[nodiscard]]
+  bool usesMixedScaling() const;
+  /*
+   * Returns true, if the pipeline was created for the same scaling options and the same number of input and output variables.
+   */
+  [[nodiscard]]
+  bool matchesOptions(ProgramOptions const& options) const;
+  [[nodiscard]]
+  MinMaxValues const& getMinMax() const;
+  [[nodiscard]]
+  MixedMinMaxValues const& getMixedMinMax() const;
+  /*
+   * Returns the threshold of the mixed scaling after the normalization.
+   */
+  [[nodiscard]]
+  TensorDataType getNormalizedThreshold() const;
+  /*
+   * Returns the range of the normalized values of each input and output column (the union of both regions of a mixed scaling).
+   */
+  [[nodiscard]]
+  MinMaxValues getNormalizedValueRanges() const;
+
+  /*
+   * Scales the output values of the given data in place (without normalizing them). Used before the min/max values of the scaled data are known.
+   * Without any scaling, the data is not touched.
+   */
+  void scale(Dataset& data, uint32_t numberOfThreads = 1) const;
+  /*
+   * Normalizes the given (already scaled) data in place.
+   */
+  void normalize(Dataset& data, uint32_t numberOfThreads = 1) const;
+  /*
+   * Scales and normalizes the given data in place.
+   */
+  void forward(Dataset& data, uint32_t numberOfThreads = 1) const;
+  /*
+   * Normalizes the given input values in place.
+   */
+  void normalizeInputs(torch::Tensor& inputs, uint32_t numberOfThreads = 1) const;
+  /*
+   * Denormalizes the given input values in place. If limitValues is true, the values are limited to the normalized range first.
+   */
+  void denormalizeInputs(torch::Tensor& inputs, bool limitValues = false, uint32_t numberOfThreads = 1) const;
+  /*
+   * Denormalizes and unscales the given output values in place. The normalized input values of the same rows decide the region of a mixed scaling.
+   * If limitValues is true, the values are limited to the normalized range first.
+   */
+  void inverseOutputs(torch::Tensor const& normalizedInputs, torch::Tensor& outputs, bool limitValues = false, uint32_t numberOfThreads = 1) const;
+
+  /*
+   * Writes the pipeline (including the min/max values and the precomputed coefficients) to the given archive.
+   */
+  void write(torch::serialize::OutputArchive& archive) const;
+  /*
+   * Reads a pipeline from the given archive. Throws an exception, if the archive does not contain a valid pipeline.
+   */
+  [[nodiscard]]
+  static TransformPipeline Read(torch::serialize::InputArchive& archive);
+  /*
+   * Saves the pipeline to the given file path.
+   */
+  bool save(FilePath const& path) const;
+  /*
+   * Loads a pipeline, which was saved with save(), from the given file path.
+   */
+  [[nodiscard]]
+  static std::optional<TransformPipeline> Load(FilePath const& path);
+
+  /*
+   * Scaling of the output values.
+   */
+  enum class Scaling : uint8_t
+  {
+    None, Logarithmic, SquareRoot
+  };
+
+private:
+  /*
+   * Transformation 'value * scale + offset' of each column.
+   */
+  class AffineTransform
+  {
+  public:
+    std::vector<TensorDataType> scale {};
+    std::vector<TensorDataType> offset {};
+  };
+
+  static constexpr size_t NUMBER_OF_REGIONS = 2; // region 0: below or equal to the mixed scaling threshold (or all rows without mixed scaling)
+
+  void setNormalization(MinMaxVector const& inputMinMax, std::array<MinMaxVector const*, NUMBER_OF_REGIONS> const& outputMinMax);
+  void transform(Dataset& data, bool scaleOutputs, bool normalizeValues, uint32_t numberOfThreads) const;
+
+private:
+  uint32_t numberOfInputVariables = 0;
+  uint32_t numberOfOutputVariables = 0;
+  bool mixedScaling = false;
+  uint32_t thresholdVariable = 0;
+  TensorDataType threshold = 0.0;
+  TensorDataType normalizedThreshold = 0.0;
+  std::array<Scaling, NUMBER_OF_REGIONS> outputScaling {Scaling::None, Scaling::None};
+
+  AffineTransform inputNormalization {}; // identity transformations until the min/max values are set
+  AffineTransform inputDenormalization {};
+  std::array<AffineTransform, NUMBER_OF_REGIONS> outputNormalization {};
+  std::array<AffineTransform, NUMBER_OF_REGIONS> outputDenormalization {};
+  std::array<std::pair<TensorDataType, TensorDataType>, NUMBER_OF_REGIONS> normalizedOutputRange {};
+
+  MinMaxValues minMax {};
+  MixedMinMaxValues mixedMinMax {};
+};
+
+}
@@ -0,0 +1,149 @@
+#include "NeuralNetwork/asyncvalidator.h"
+
+#include <chrono>
+
+namespace NeuralNetwork {
+
+AsyncValidator::AsyncValidator(Network& network_, Network evaluationNetwork_, DataPartIterator forEachValidationPart_,
+                               Utilities::TransformPipeline const& pipeline) :
+  network(network_), evaluationNetwork(std::move(evaluationNetwork_)), evaluationAnalyzer(evaluationNetwork, pipeline),
+  forEachValidationPart(std::move(forEachValidationPart_))
+{
+}
+
+AsyncValidator::~AsyncValidator()
+{
+  if (validation.valid()) {
+    validation.wait();
+  }
+}
+
+bool AsyncValidator::start(uint32_t const epoch)
+{
+  if (validation.valid()) {
+    if (validation.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return false;
+    }
+    (void) takeResult();
+  }
+
+  // The snapshot is a copy of the parameters, the evaluation network is not used by another thread at this point:
+  {
+    torch::NoGradGuard noGrad;
+    auto parameters = network->parameters();
+    auto evaluationParameters = evaluationNetwork->parameters();
+    for (size_t i = 0; i < parameters.size(); ++i) {
+      evaluationParameters[i].copy_(parameters[i]);
+    }
+  }
+
+  validatedEpoch = epoch;
+  validation = std::async(std::launch::async, [this]() {
+    ErrorAccumulator errors{};
+    evaluationAnalyzer.accumulateErrors(forEachValidationPart, errors);
+    return errors.getMeanSquaredError();
+  });
+  return true;
+}
+
+std::optional<double> AsyncValidator::poll()
+{
+  if (!validation.valid() || validation.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return std::nullopt;
+  }
+  return takeResult();
+}
+
+std::optional<double> AsyncValidator::finish()
+{
+  if (!validation.valid()) {
+    return std::nullopt;
+  }
+  return takeResult();
+}
+
+bool AsyncValidator::restoreBestParameters()
+{
+  if (bestParameters.empty()) {
+    return false;
+  }
+
+  torch::NoGradGuard noGrad;
+  auto parameters = network->parameters();
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    parameters[i].copy_(bestParameters[i]);
+  }
+  return true;
+}
+
+uint32_t AsyncValidator::getBestEpoch() const
+{
+  return bestEpoch;
+}
+
+double AsyncValidator::getBestError() const
+{
+  return bestError;
+}
+
+uint32_t AsyncValidator::getNumberOfValidationsWithoutImprovement() const
+{
+  return numberOfValidationsWithoutImprovement;
+}
+
+void AsyncValidator::write(torch::serialize::OutputArchive& archive) const
+{
+  archive.write("state", torch::tensor(std::vector<int64_t>{static_cast<int64_t>(bestParameters.size()), bestEpoch,
+                                                            numberOfValidationsWithoutImprovement}, torch::kInt64));
+  archive.write("bestError", torch::tensor(std::vector<double>{bestError}, torch::kDouble));
+  for (size_t i = 0; i < bestParameters.size(); ++i) {
+    archive.write("bestParameter" + std::to_string(i), bestParameters[i]);
+  }
+}
+
+void AsyncValidator::read(torch::serialize::InputArchive& archive)
+{
+  torch::Tensor state, storedBestError;
+  archive.read("state", state);
+  archive.read("bestError", storedBestError);
+  if (state.numel() != 3 || storedBestError.numel() != 1) {
+    throw std::runtime_error("invalid state of the validation");
+  }
+
+  auto stateValues = state.to(torch::kInt64).contiguous();
+  auto statePointer = stateValues.data_ptr<int64_t>();
+  auto numberOfParameters = evaluationNetwork->parameters().size();
+  if (statePointer[0] != 0 && statePointer[0] != static_cast<int64_t>(numberOfParameters)) {
+    throw std::runtime_error("the validated parameters do not match the network");
+  }
+
+  bestParameters.clear();
+  for (int64_t i = 0; i < statePointer[0]; ++i) {
+    torch::Tensor parameter;
+    archive.read("bestParameter" + std::to_string(i), parameter);
+    bestParameters.push_back(parameter);
+  }
+  bestEpoch = static_cast<uint32_t>(statePointer[1]);
+  numberOfValidationsWithoutImprovement = static_cast<uint32_t>(statePointer[2]);
+  bestError = storedBestError.item<double>();
+}
+
+double AsyncValidator::takeResult()
+{
+  auto error = validation.get();
+  if (error < bestError) {
+    numberOfValidationsWithoutImprovement = 0;
+    bestError = error;
+    bestEpoch = validatedEpoch;
+
+    bestParameters.clear();
+    for (auto const& parameter : evaluationNetwork->parameters()) {
+      bestParameters.push_back(parameter.detach().clone());
+    }
+  } else {
+    ++numberOfValidationsWithoutImprovement;
+  }
+  return error;
+}
+
+}
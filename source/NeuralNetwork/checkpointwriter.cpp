@@ -0,0 +1,61 @@
+#include "NeuralNetwork/checkpointwriter.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace NeuralNetwork {
+
+CheckpointWriter::CheckpointWriter(FilePath path_) :
+  path(std::move(path_))
+{
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+  (void) finish();
+}
+
+void CheckpointWriter::write(torch::serialize::OutputArchive& archive)
+{
+  // The archive references the tensors of the training, so it is serialized before the training continues:
+  std::ostringstream stream{};
+  archive.save_to(stream);
+
+  (void) finish();
+  writing = std::async(std::launch::async, [this, content = stream.str()]() {
+    return writeFile(content);
+  });
+}
+
+bool CheckpointWriter::finish()
+{
+  if (!writing.valid()) {
+    return true;
+  }
+
+  if (!writing.get()) {
+    std::cout << "\n[Warning] Unable to write the checkpoint to \"" << path << "\"." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool CheckpointWriter::writeFile(std::string const& content) const
+{
+  auto temporaryPath = path + ".tmp";
+  std::error_code errorCode{};
+
+  std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+  file.write(content.data(), static_cast<std::streamsize>(content.size()));
+  file.close();
+  if (!file) {
+    std::filesystem::remove(temporaryPath, errorCode);
+    return false;
+  }
+
+  std::filesystem::rename(temporaryPath, path, errorCode);
+  return !errorCode;
+}
+
+}
@@ -0,0 +1,132 @@
+#include "NeuralNetwork/dataparalleltrainer.h"
+
+namespace NeuralNetwork {
+
+DataParallelTrainer::DataParallelTrainer(Network& network, std::vector<Network> const& replicas)
+{
+  for (size_t i = 0; i <= replicas.size(); ++i) {
+    auto worker = std::make_unique<Worker>();
+    worker->network = (i == 0) ? network : replicas[i - 1];
+    worker->parameters = worker->network->parameters();
+    workers.push_back(std::move(worker));
+  }
+
+  for (size_t i = 1; i < workers.size(); ++i) {
+    threads.emplace_back([this, i]() { runWorker(i); });
+  }
+}
+
+DataParallelTrainer::~DataParallelTrainer()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopWorkers = true;
+  }
+  batchStarted.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void DataParallelTrainer::computeGradients(torch::Tensor const& inputs_, torch::Tensor const& outputs_, double const lossNormalization_,
+                                           ErrorAccumulator& errors)
+{
+  uint64_t batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    inputs = inputs_;
+    outputs = outputs_;
+    lossNormalization = lossNormalization_;
+    // Each active worker gets at least one row:
+    numberOfActiveWorkers = std::min<size_t>(workers.size(), static_cast<size_t>(inputs.size(0)));
+    batch = ++currentBatch;
+  }
+  batchStarted.notify_all();
+
+  // Returns after all gradients were added to the trained network. Errors of the workers are passed up the tree as well:
+  computeSlice(0, batch);
+  if (workers[0]->error) {
+    std::rethrow_exception(workers[0]->error);
+  }
+
+  auto numberOfRows = static_cast<size_t>(outputs.size(0));
+  for (size_t i = 0; i < numberOfActiveWorkers; ++i) {
+    auto begin = i * numberOfRows / numberOfActiveWorkers;
+    auto end = (i + 1) * numberOfRows / numberOfActiveWorkers;
+    errors.add(workers[i]->predictions, outputs.slice(0, static_cast<int64_t>(begin), static_cast<int64_t>(end)));
+  }
+}
+
+void DataParallelTrainer::runWorker(size_t const workerIndex)
+{
+  uint64_t lastBatch = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      batchStarted.wait(lock, [this, lastBatch]() { return currentBatch != lastBatch || stopWorkers; });
+      if (stopWorkers) {
+        return;
+      }
+      lastBatch = currentBatch;
+    }
+
+    computeSlice(workerIndex, lastBatch);
+  }
+}
+
+void DataParallelTrainer::computeSlice(size_t const workerIndex, uint64_t const batch)
+{
+  auto& worker = *workers[workerIndex];
+  worker.hasGradients = false;
+  worker.error = nullptr;
+
+  if (workerIndex < numberOfActiveWorkers) {
+    try {
+      if (workerIndex > 0) {
+        // The replica starts with the current parameters and without gradients:
+        torch::NoGradGuard noGrad;
+        auto const& trainedParameters = workers[0]->parameters;
+        for (size_t i = 0; i < worker.parameters.size(); ++i) {
+          worker.parameters[i].copy_(trainedParameters[i]);
+        }
+        worker.network->zero_grad();
+      }
+
+      auto numberOfRows = static_cast<size_t>(inputs.size(0));
+      auto begin = static_cast<int64_t>(workerIndex * numberOfRows / numberOfActiveWorkers);
+      auto end = static_cast<int64_t>((workerIndex + 1) * numberOfRows / numberOfActiveWorkers);
+
+      auto prediction = worker.network->forward(inputs.slice(0, begin, end));
+      auto loss = torch::mse_loss(prediction, outputs.slice(0, begin, end).to(prediction.scalar_type()), torch::Reduction::Sum) / lossNormalization;
+      loss.backward();
+
+      worker.predictions = prediction.detach();
+      worker.hasGradients = true;
+    } catch (...) {
+      worker.error = std::current_exception();
+    }
+  }
+
+  // Adds the gradients of the workers below this one in the tree. The active workers are the first ones, so an inactive worker has no active
+  // workers below it:
+  for (size_t distance = 1; workerIndex % (2 * distance) == 0 && workerIndex + distance < workers.size(); distance *= 2) {
+    auto& child = *workers[workerIndex + distance];
+    while (child.finishedBatch.load(std::memory_order_acquire) != batch) {
+      std::this_thread::yield();
+    }
+
+    if (child.error && !worker.error) {
+      worker.error = child.error;
+    }
+    if (child.hasGradients && worker.hasGradients) {
+      torch::NoGradGuard noGrad;
+      for (size_t i = 0; i < worker.parameters.size(); ++i) {
+        worker.parameters[i].grad().add_(child.parameters[i].grad());
+      }
+    }
+  }
+
+  worker.finishedBatch.store(batch, std::memory_order_release);
+}
+
+}
@@ -0,0 +1,73 @@
+#include "NeuralNetwork/hogwildtrainer.h"
+#include "Utilities/parallel.h"
+
+namespace NeuralNetwork {
+
+HogwildTrainer::HogwildTrainer(Network& network, std::vector<Network> const& replicas, Utilities::ProgramOptions const& options)
+{
+  torch::NoGradGuard noGrad;
+  auto trainedParameters = network->parameters();
+
+  for (size_t i = 0; i <= replicas.size(); ++i) {
+    Worker worker{};
+    worker.network = (i == 0) ? network : replicas[i - 1];
+
+    // The parameters of a replica share the storage of the trained parameters, the gradients are separate:
+    auto parameters = worker.network->parameters();
+    if (i > 0) {
+      for (size_t j = 0; j < parameters.size(); ++j) {
+        parameters[j].set_(trainedParameters[j]);
+      }
+    }
+    worker.optimizer = std::make_unique<Optimizer>(parameters, options);
+    workers.push_back(std::move(worker));
+  }
+}
+
+void HogwildTrainer::startEpoch(uint32_t const epoch, uint32_t const numberOfDeteriorationsInRow)
+{
+  for (auto& worker : workers) {
+    worker.optimizer->startEpoch(epoch, numberOfDeteriorationsInRow);
+  }
+}
+
+void HogwildTrainer::train(Dataset const& data, ErrorAccumulator& errors)
+{
+  auto numberOfWorkers = workers.size();
+  Utilities::runInParallel(numberOfWorkers, static_cast<uint32_t>(numberOfWorkers), [this, &data, numberOfWorkers](size_t const workerIndex) {
+    auto& worker = workers[workerIndex];
+    auto shard = data.slice(workerIndex * data.size() / numberOfWorkers, (workerIndex + 1) * data.size() / numberOfWorkers);
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto const& [x, y] : shard) {
+      auto prediction = worker.network->forward(x);
+
+      auto loss = torch::mse_loss(prediction, y.to(prediction.scalar_type()));
+      worker.errors.add(prediction, y);
+
+      worker.optimizer->zeroGrad();
+
+      loss.backward();
+      worker.optimizer->step();
+    }
+    worker.trainingTime += std::chrono::steady_clock::now() - start;
+    worker.numberOfTrainedRows += shard.size();
+  });
+
+  for (auto& worker : workers) {
+    errors.add(worker.errors);
+    worker.errors.reset();
+  }
+}
+
+std::vector<double> HogwildTrainer::getRowsPerSecond() const
+{
+  std::vector<double> rowsPerSecond{};
+  for (auto const& worker : workers) {
+    auto seconds = std::chrono::duration<double>(worker.trainingTime).count();
+    rowsPerSecond.push_back(seconds > 0.0 ? static_cast<double>(worker.numberOfTrainedRows) / seconds : 0.0);
+  }
+  return rowsPerSecond;
+}
+
+}
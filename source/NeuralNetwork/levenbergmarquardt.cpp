@@ -0,0 +1,173 @@
+#include "NeuralNetwork/levenbergmarquardt.h"
+
+#include <limits>
+
+namespace NeuralNetwork {
+
+namespace {
+
+const double   INITIAL_DAMPING = 1e-3;
+const double   DAMPING_DECREASE = 0.1;
+const double   DAMPING_INCREASE = 10.0;
+const double   MAXIMUM_DAMPING = 1e10;
+const double   LEAKY_RELU_SLOPE = 0.2;
+const uint64_t BYTES_PER_JACOBIAN_SLICE = 64 << 20;
+const size_t   ROWS_PER_EVALUATION_SLICE = 1 << 14;
+
+}
+
+LevenbergMarquardt::LevenbergMarquardt(Network& network_) :
+  network(network_), parameters(network_->parameters()), damping(INITIAL_DAMPING)
+{
+  for (auto const& parameter : parameters) {
+    numberOfParameters += parameter.numel();
+  }
+}
+
+bool LevenbergMarquardt::step(DataPartIterator const& forEachPart, ErrorAccumulator& errors)
+{
+  torch::NoGradGuard noGrad;
+
+  // The normal equations are accumulated in double precision, independent of the precision of the network:
+  auto jacobianProduct = torch::zeros({numberOfParameters, numberOfParameters}, torch::kDouble);
+  auto gradient = torch::zeros({numberOfParameters, 1}, torch::kDouble);
+  forEachPart([this, &jacobianProduct, &gradient](Dataset const& part) {
+    accumulateNormalEquations(part, jacobianProduct, gradient);
+  });
+
+  // The errors before and after a step are computed with the network, so that they have the same precision:
+  errors.reset();
+  auto error = calculateSumOfSquaredErrors(forEachPart, errors);
+
+  std::vector<torch::Tensor> previousParameters{};
+  for (auto const& parameter : parameters) {
+    previousParameters.push_back(parameter.clone());
+  }
+
+  auto identity = torch::eye(numberOfParameters, torch::kDouble);
+  while (damping <= MAXIMUM_DAMPING) {
+    torch::Tensor delta;
+    try {
+      delta = torch::cholesky_solve(-gradient, torch::cholesky(jacobianProduct + damping * identity));
+    } catch (std::exception const&) {
+      // The damped matrix is not positive definite (numerically), so a larger damping factor is needed:
+      damping *= DAMPING_INCREASE;
+      continue;
+    }
+
+    int64_t offset = 0;
+    for (auto& parameter : parameters) {
+      parameter.add_(delta.narrow(0, offset, parameter.numel()).view_as(parameter).to(parameter.scalar_type()));
+      offset += parameter.numel();
+    }
+
+    ErrorAccumulator stepErrors{};
+    if (calculateSumOfSquaredErrors(forEachPart, stepErrors) < error) {
+      errors = std::move(stepErrors);
+      damping = std::max(damping * DAMPING_DECREASE, std::numeric_limits<double>::min());
+      return true;
+    }
+
+    for (size_t i = 0; i < parameters.size(); ++i) {
+      parameters[i].copy_(previousParameters[i]);
+    }
+    damping *= DAMPING_INCREASE;
+  }
+
+  return false;
+}
+
+uint64_t LevenbergMarquardt::GetMemoryUsageInBytes(uint64_t const numberOfParameters)
+{
+  return 2 * numberOfParameters * numberOfParameters * sizeof(double) + BYTES_PER_JACOBIAN_SLICE;
+}
+
+void LevenbergMarquardt::write(torch::serialize::OutputArchive& archive) const
+{
+  archive.write("damping", torch::tensor(std::vector<double>{damping}, torch::kDouble));
+}
+
+void LevenbergMarquardt::read(torch::serialize::InputArchive& archive)
+{
+  torch::Tensor storedDamping;
+  archive.read("damping", storedDamping);
+  if (storedDamping.numel() != 1 || !(storedDamping.item<double>() > 0.0)) {
+    throw std::runtime_error("invalid damping factor of Levenberg-Marquardt");
+  }
+  damping = storedDamping.item<double>();
+}
+
+void LevenbergMarquardt::accumulateNormalEquations(Dataset const& rows, torch::Tensor& jacobianProduct, torch::Tensor& gradient) const
+{
+  auto rowsPerSlice = getRowsPerSlice(rows.getNumberOfOutputVariables());
+  for (size_t begin = 0; begin < rows.size(); begin += rowsPerSlice) {
+    auto slice = rows.slice(begin, std::min(begin + rowsPerSlice, rows.size()));
+
+    torch::Tensor outputs;
+    auto jacobian = calculateJacobian(slice.inputs(), outputs);
+    auto errors = (outputs - slice.outputs().to(torch::kDouble)).reshape({-1, 1});
+
+    jacobianProduct.addmm_(jacobian.t(), jacobian);
+    gradient.addmm_(jacobian.t(), errors);
+  }
+}
+
+torch::Tensor LevenbergMarquardt::calculateJacobian(torch::Tensor const& inputs, torch::Tensor& outputs) const
+{
+  auto numberOfLayers = parameters.size() / 2;
+
+  // Forward pass, which keeps the inputs and the derivatives of the activation function of each layer:
+  std::vector<torch::Tensor> layerInputs{inputs.to(torch::kDouble)};
+  std::vector<torch::Tensor> activationDerivatives{};
+  for (size_t layer = 0; layer < numberOfLayers; ++layer) {
+    auto weight = parameters[2 * layer].to(torch::kDouble);
+    auto bias = parameters[2 * layer + 1].to(torch::kDouble);
+    auto z = torch::addmm(bias, layerInputs.back(), weight.t());
+    activationDerivatives.push_back(torch::where(z > 0, torch::ones_like(z), torch::full_like(z, LEAKY_RELU_SLOPE)));
+    layerInputs.push_back(torch::leaky_relu(z, LEAKY_RELU_SLOPE));
+  }
+  outputs = layerInputs.back();
+
+  // Backward pass for all outputs at once. delta [numberOfRows, numberOut, numberOfNodes] is the derivative of each output with respect to
+  // the pre-activation values of the current layer:
+  auto numberOfRows = inputs.size(0);
+  auto numberOfOutputs = outputs.size(1);
+  auto delta = torch::diag_embed(activationDerivatives.back());
+
+  std::vector<torch::Tensor> blocks(numberOfLayers);
+  for (size_t layer = numberOfLayers; layer-- > 0;) {
+    auto const& layerInput = layerInputs[layer];
+    auto weightDerivative = delta.unsqueeze(3) * layerInput.unsqueeze(1).unsqueeze(2);
+    blocks[layer] = torch::cat({weightDerivative.reshape({numberOfRows, numberOfOutputs, -1}), delta}, 2);
+
+    if (layer > 0) {
+      delta = torch::matmul(delta, parameters[2 * layer].to(torch::kDouble)) * activationDerivatives[layer - 1].unsqueeze(1);
+    }
+  }
+
+  // The columns have the order of the parameters (weight and bias of each layer):
+  return torch::cat(blocks, 2).reshape({numberOfRows * numberOfOutputs, numberOfParameters});
+}
+
+double LevenbergMarquardt::calculateSumOfSquaredErrors(DataPartIterator const& forEachPart, ErrorAccumulator& errors) const
+{
+  double error = 0.0;
+  forEachPart([this, &error, &errors](Dataset const& part) {
+    for (size_t begin = 0; begin < part.size(); begin += ROWS_PER_EVALUATION_SLICE) {
+      auto slice = part.slice(begin, std::min(begin + ROWS_PER_EVALUATION_SLICE, part.size()));
+      auto prediction = network->forward(slice.inputs()).to(torch::kDouble);
+      error += (prediction - slice.outputs().to(torch::kDouble)).pow(2).sum().item<double>();
+      errors.add(prediction, slice.outputs());
+    }
+  });
+  return error;
+}
+
+size_t LevenbergMarquardt::getRowsPerSlice(int64_t const numberOfOutputs) const
+{
+  // The Jacobian of a slice and the temporary derivatives of the largest layer have about the same size:
+  auto bytesPerRow = static_cast<uint64_t>(numberOfOutputs * numberOfParameters) * sizeof(double);
+  return std::max<size_t>(1, BYTES_PER_JACOBIAN_SLICE / bytesPerRow);
+}
+
+}
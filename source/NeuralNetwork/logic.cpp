@@ -1,68 +1,834 @@
 #include "NeuralNetwork/logic.h"
+#include "NeuralNetwork/asyncvalidator.h"
+#include "NeuralNetwork/checkpointwriter.h"
+#include "NeuralNetwork/dataparalleltrainer.h"
+#include "NeuralNetwork/hogwildtrainer.h"
+#include "NeuralNetwork/levenbergmarquardt.h"
+#include "NeuralNetwork/optimizer.h"
+#include "Utilities/binarydataset.h"
+#include "Utilities/dataloader.h"
+#include "Utilities/datasetcache.h"
 #include "Utilities/dataprocessor.h"
 #include "Utilities/datasplitter.h"
 #include "Utilities/fileparser.h"
 
+#include <unistd.h>
+
 #include <chrono>
+#include <filesystem>
 #include <random>
+#include <sstream>
+
+namespace NeuralNetwork {
+
+namespace {
+
+const uint64_t BYTES_PER_MB = 1 << 20;
+const size_t   ROWS_PER_FULL_BATCH_SLICE = 1 << 14; // number of rows of a full batch (L-BFGS) which are computed at once to limit the memory usage
+const uint64_t LEVENBERG_MARQUARDT_MEMORY_WARNING_IN_MB = 4096; // used if no memory limit is set
+const int64_t  CHECKPOINT_FORMAT_VERSION = 1;
+
+/*
+ * Removes the file at the given path, when it goes out of scope.
+ */
+class TemporaryFile
+{
+public:
+  explicit TemporaryFile(std::filesystem::path path_) : path(std::move(path_)) {}
+  ~TemporaryFile()
+  {
+    std::error_code errorCode{};
+    std::filesystem::remove(path, errorCode);
+  }
+
+  TemporaryFile(TemporaryFile const&) = delete;
+  TemporaryFile& operator=(TemporaryFile const&) = delete;
+
+  std::filesystem::path path;
+};
+
+/*
+ * Writes the progress records to the given archive as one tensor per column.
+ */
+void writeProgress(torch::serialize::OutputArchive& archive, ProgressVector const& progress)
+{
+  std::vector<int64_t> epochs{};
+  std::vector<int64_t> elapsedTimes{};
+  std::vector<int64_t> numbersOfScores{};
+  std::vector<double> meanSquaredErrors{};
+  std::vector<double> r2Scores{};
+  for (auto const& dataSet : progress) {
+    epochs.push_back(dataSet.epoch);
+    elapsedTimes.push_back(static_cast<int64_t>(dataSet.elapsedTimeInMS));
+    numbersOfScores.push_back(static_cast<int64_t>(dataSet.r2Score.size()));
+    meanSquaredErrors.push_back(dataSet.meanSquaredError);
+    r2Scores.insert(r2Scores.end(), dataSet.r2Score.begin(), dataSet.r2Score.end());
+  }
+
+  archive.write("epochs", torch::tensor(epochs, torch::kInt64));
+  archive.write("elapsedTimes", torch::tensor(elapsedTimes, torch::kInt64));
+  archive.write("numbersOfScores", torch::tensor(numbersOfScores, torch::kInt64));
+  archive.write("meanSquaredErrors", torch::tensor(meanSquaredErrors, torch::kDouble));
+  archive.write("r2Scores", torch::tensor(r2Scores, torch::kDouble));
+}
+
+/*
+ * Reads the progress records, which were written with writeProgress(), from the given archive.
+ */
+ProgressVector readProgress(torch::serialize::InputArchive& archive)
+{
+  torch::Tensor epochs, elapsedTimes, numbersOfScores, meanSquaredErrors, r2Scores;
+  archive.read("epochs", epochs);
+  archive.read("elapsedTimes", elapsedTimes);
+  archive.read("numbersOfScores", numbersOfScores);
+  archive.read("meanSquaredErrors", meanSquaredErrors);
+  archive.read("r2Scores", r2Scores);
+
+  auto numberOfRecords = epochs.numel();
+  if (elapsedTimes.numel() != numberOfRecords || numbersOfScores.numel() != numberOfRecords || meanSquaredErrors.numel() != numberOfRecords ||
+      (numberOfRecords > 0 && numbersOfScores.sum().item<int64_t>() != r2Scores.numel())) {
+    throw std::runtime_error("invalid progress records");
+  }
+
+  auto epochValues = epochs.to(torch::kInt64).contiguous();
+  auto elapsedTimeValues = elapsedTimes.to(torch::kInt64).contiguous();
+  auto numberOfScoresValues = numbersOfScores.to(torch::kInt64).contiguous();
+  auto meanSquaredErrorValues = meanSquaredErrors.to(torch::kDouble).contiguous();
+  auto r2ScoreValues = r2Scores.to(torch::kDouble).contiguous();
+  auto r2ScorePointer = r2ScoreValues.data_ptr<double>();
+
+  ProgressVector progress{};
+  for (int64_t i = 0; i < numberOfRecords; ++i) {
+    auto numberOfScores = numberOfScoresValues.data_ptr<int64_t>()[i];
+    progress.emplace_back(LearnProgressDataSet{
+      static_cast<uint32_t>(epochValues.data_ptr<int64_t>()[i]),
+      std::vector<double>(r2ScorePointer, r2ScorePointer + numberOfScores),
+      meanSquaredErrorValues.data_ptr<double>()[i],
+      static_cast<uint64_t>(elapsedTimeValues.data_ptr<int64_t>()[i])
+    });
+    r2ScorePointer += numberOfScores;
+  }
+  return progress;
+}
+
+/*
+ * Returns the state of the random number generator as a tensor of its words.
+ */
+torch::Tensor toTensor(std::mt19937_64 const& generator)
+{
+  std::stringstream stream{};
+  stream << generator;
+
+  std::vector<int64_t> state{};
+  uint64_t word = 0;
+  while (stream >> word) {
+    state.push_back(static_cast<int64_t>(word));
+  }
+  return torch::tensor(state, torch::kInt64);
+}
+
+/*
+ * Sets the state of the random number generator to the state, which was returned by toTensor().
+ */
+void setState(std::mt19937_64& generator, torch::Tensor const& state)
+{
+  auto stateValues = state.to(torch::kInt64).contiguous();
+  std::stringstream stream{};
+  for (int64_t i = 0; i < stateValues.numel(); ++i) {
+    stream << static_cast<uint64_t>(stateValues.data_ptr<int64_t>()[i]) << ' ';
+  }
+
+  stream >> generator;
+  if (stream.fail()) {
+    throw std::runtime_error("invalid state of the random number generator");
+  }
+}
+
+}
+
+bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
+{
+  options = user_options;
+
+  if (options.ConvertInputFilePath != Utilities::DefaultValues::CONVERT_INPUT_FILE_PATH) {
+    return convertInputFile();
+  }
+
+  useMixedScaling = options.LogLinScaling || options.LogSqrtScaling;
+  pipeline = Utilities::TransformPipeline(options);
+  torch::set_num_threads(options.NumberOfThreads);
+
+  if (options.RNGSeed) {
+    torch::manual_seed(*options.RNGSeed);
+  }
+
+  if (!loadCheckpoint()) {
+    return false;
+  }
+
+  if (options.MemoryLimitInMB) {
+    return performOutOfCoreRequest();
+  }
+
+  Dataset allData{};
+  if (!loadPreprocessedData(allData)) {
+    return false;
+  }
+
+  if (options.OutputMinMaxFilePath != Utilities::DefaultValues::OUTPUT_MIN_MAX_FILE_PATH) {
+    saveMinMaxToFile();
+  }
+
+  if (options.OutputPipelineFilePath != Utilities::DefaultValues::OUTPUT_PIPELINE_FILE_PATH) {
+    (void) pipeline.save(options.OutputPipelineFilePath);
+  }
+
+  if (options.CompactStorageFormat) {
+    // Only the compact data is kept in memory during the training, its rows are decoded batch by batch. The exact data is read again for
+    // the output files and the behaviour after the training:
+    try {
+      allData = allData.compact(createCompactEncoding(), TORCH_DATA_TYPE);
+    } catch (std::runtime_error const& error) {
+      std::cout << "Error: The preprocessed data cannot be stored compactly (" << error.what() << ")." << std::endl;
+      return false;
+    }
+  }
+
+  // The preprocessing is done in double precision. The network is trained with a copy in the precision of the user, the evaluation and the
+  // output files use the data in double precision (the region of a mixed scaling is decided with the exact normalized values).
+  // The compact data is not copied, its rows are decoded to the precision of the user instead:
+  auto trainingData = allData.to(options.Precision);
+
+  if (!configureNetwork()) {
+    return false;
+  }
+
+  std::pair<Dataset, Dataset> data;
+
+  if (options.ValidateAfterTraining) {
+    // The same seed results in the same split of both copies:
+    data = Utilities::DataSplitter::splitDataRandomly(allData, 100.0 - options.ValidationPercentage, splitSeed);
+    trainingData = Utilities::DataSplitter::splitDataRandomly(trainingData, 100.0 - options.ValidationPercentage, splitSeed).first;
+  } else {
+    data = std::make_pair(allData, Dataset());
+  }
+
+  if (options.BatchVariable.has_value()) {
+    useBatchTraining = true;
+
+    batchedTrainingData = Utilities::DataSplitter::splitDataIntoBatches(trainingData, options.BatchVariable.value());
+
+    if (options.DebugOutput) {
+      std::cout << "Split training data (" << data.first.size() << " data points) into " << batchedTrainingData.size() << " batches." << std::endl;
+      std::cout << "Size of first batch: " << batchedTrainingData.front().size() << std::endl;
+    }
+  }
+
+  if (options.DebugOutput) {
+    std::cout << "Start the training..." << std::endl;
+  }
+
+  if (!trainNetwork(trainingData, data.second)) {
+    return false;
+  }
+
+  if (options.DebugOutput) {
+    std::cout << "\nTraining finished." << std::endl;
+  }
+
+  network->eval();
+
+  if (options.OutputNetworkParameters != Utilities::DefaultValues::OUTPUT_NETWORK_PARAMETERS) {
+    torch::save(network, options.OutputNetworkParameters);
+  }
+
+  bool useExactData = options.OutputValuesFilePath != Utilities::DefaultValues::OUTPUT_VALUE ||
+                      options.OutputDiffFilePath != Utilities::DefaultValues::OUTPUT_DIFF ||
+                      options.OutputRelativeDiffFilePath != Utilities::DefaultValues::OUTPUT_RELATIVE_DIFF || options.PrintBehaviour;
+  if (allData.isCompact() && useExactData) {
+    // The compact data is released, before the exact data is read again and split the same way:
+    allData = Dataset();
+    data = std::pair<Dataset, Dataset>();
+    trainingData = Dataset();
+    if (!reloadPreprocessedData(allData)) {
+      return false;
+    }
+    if (options.ValidateAfterTraining) {
+      data = Utilities::DataSplitter::splitDataRandomly(allData, 100.0 - options.ValidationPercentage, splitSeed);
+    } else {
+      data = std::make_pair(allData, Dataset());
+    }
+  }
+
+  if (options.OutputValuesFilePath != Utilities::DefaultValues::OUTPUT_VALUE) {
+    saveValuesToFile(allData, options.OutputValuesFilePath);
+  }
+
+  if (options.OutputDiffFilePath != Utilities::DefaultValues::OUTPUT_DIFF) {
+    saveDiffToFile(allData, options.OutputDiffFilePath, false);
+  }
+
+  if (options.OutputRelativeDiffFilePath != Utilities::DefaultValues::OUTPUT_RELATIVE_DIFF) {
+    saveDiffToFile(allData, options.OutputRelativeDiffFilePath, true);
+  }
+
+  if (options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH) {
+    Utilities::FileParser::SaveProgressData(trainingProgress, options.SaveProgressFilePath);
+  }
+
+  // Output behaviour of network:
+  if (options.PrintBehaviour) {
+    std::cout << std::endl;
+    if (options.ValidateAfterTraining) {
+      std::cout << "R2 score (training): " << analyzer->calculateR2Score(data.first) << std::endl;
+      std::cout << "R2 score alternate (training): " << analyzer->calculateR2ScoreAlternate(data.first) << std::endl;
+      std::cout << "R2 score alternate denormalized (training): " << analyzer->calculateR2ScoreAlternateDenormalized(data.first) << std::endl;
+      std::cout << "R2 score (validation): " << analyzer->calculateR2Score(data.second) << std::endl;
+      std::cout << "R2 score alternate (validation): " << analyzer->calculateR2ScoreAlternate(data.second) << std::endl;
+      std::cout << "R2 score alternate denormalized (validation): " << analyzer->calculateR2ScoreAlternateDenormalized(data.second) << std::endl;
+    }
+    std::cout << "R2 score (all): " << analyzer->calculateR2Score(allData) << std::endl;
+    std::cout << "R2 score alternate (all): " << analyzer->calculateR2ScoreAlternate(allData) << std::endl;
+    std::cout << "R2 score alternate denormalized (all): " << analyzer->calculateR2ScoreAlternateDenormalized(allData) << std::endl;
+
+    if (options.ValidateAfterTraining) {
+      std::cout << "\nTraining set:" << std::endl;
+      outputBehaviour(data.first);
+      std::cout << "\nValidation set:" << std::endl;
+      outputBehaviour(data.second);
+    } else {
+      outputBehaviour(allData);
+    }
+  }
+
+  if (options.InteractiveMode) {
+    performInteractiveMode();
+  }
+
+  return true;
+}
+
+bool Logic::performOutOfCoreRequest()
+{
+  if (!Utilities::BinaryDataset::IsBinaryDatasetFile(options.InputDataFilePath)) {
+    std::cout << "Error: With --memoryLimit the input has to be a binary dataset file. Please convert the input file with --convertInput first." << std::endl;
+    return false;
+  }
+
+  Utilities::BinaryDatasetReader reader(options.InputDataFilePath, options.NumberOfInputVariables, options.NumberOfOutputVariables);
+  if (!reader.isOpen()) {
+    return false;
+  }
+  inputFileHeader = reader.getFileHeader();
+
+  // Besides the values of a chunk, the normalization needs temporary matrices of the same size and the split into training and validation data
+  // needs one row index per row (the split of all rows is kept with one bit per row):
+  auto bytesPerRow = 2 * (options.NumberOfInputVariables + options.NumberOfOutputVariables) * sizeof(TensorDataType) + sizeof(int64_t);
+  auto numberOfRowsPerChunk = std::max<uint64_t>(1, (*options.MemoryLimitInMB * BYTES_PER_MB) / bytesPerRow);
+  if (options.DebugOutput) {
+    std::cout << "Stream " << reader.getNumberOfRows() << " data points in chunks of up to " << numberOfRowsPerChunk << " data points." << std::endl;
+  }
+
+  auto forEachChunk = [this, &reader, numberOfRowsPerChunk](bool normalize, ChunkFunction const& function) {
+    for (uint64_t firstRow = 0; firstRow < reader.getNumberOfRows(); firstRow += numberOfRowsPerChunk) {
+      auto chunk = reader.readRows(firstRow, std::min(numberOfRowsPerChunk, reader.getNumberOfRows() - firstRow));
+      if (!chunk) {
+        throw std::runtime_error("unable to read the input data");
+      }
+
+      // The chunk is only kept in memory until the next chunk is read:
+      auto numberOfThreads = static_cast<uint32_t>(options.NumberOfThreads);
+      if (normalize) {
+        // The chunk is trained with, so its column-major buffer is replaced by row-major matrices before they are transformed in place:
+        *chunk = chunk->contiguous();
+        pipeline.forward(*chunk, numberOfThreads);
+      } else {
+        pipeline.scale(*chunk, numberOfThreads);
+      }
+      function(*chunk, firstRow);
+    }
+  };
+
+  try {
+    if (options.DebugOutput) {
+      std::cout << "Get min/max values..." << std::endl;
+    }
+
+    bool minMaxValid = determineMinMaxValues([this, &reader, &forEachChunk]() {
+      if (!useMixedScaling && !options.LogScaling && !options.SqrtScaling) {
+        // The min/max values of a binary dataset are stored in the file (only valid for unscaled data):
+        minMax = reader.getMinMax();
+        return;
+      }
+
+      // The statistics of the chunks are merged, so the chunks are only read once:
+      auto numberOfThreads = static_cast<uint32_t>(options.NumberOfThreads);
+      Utilities::DatasetStatistics statistics{};
+      Utilities::MixedDatasetStatistics mixedStatistics{};
+      forEachChunk(false, [this, numberOfThreads, &statistics, &mixedStatistics](Dataset& rows, uint64_t) {
+        if (useMixedScaling) {
+          mixedStatistics.merge(Utilities::DataProcessor::CalculateMixedStatistics(rows, options.MixedScalingInputVariable, options.MixedScalingThreshold,
+                                                                                   numberOfThreads));
+        } else {
+          statistics.merge(Utilities::DataProcessor::CalculateStatistics(rows, numberOfThreads));
+        }
+      });
+
+      if (useMixedScaling) {
+        mixedScalingMinMax = mixedStatistics.getMixedMinMax();
+      } else {
+        minMax = statistics.getMinMax();
+      }
+    });
+    if (!minMaxValid) {
+      return false;
+    }
+
+    if (options.OutputMinMaxFilePath != Utilities::DefaultValues::OUTPUT_MIN_MAX_FILE_PATH) {
+      saveMinMaxToFile();
+    }
+
+    if (options.OutputPipelineFilePath != Utilities::DefaultValues::OUTPUT_PIPELINE_FILE_PATH) {
+      (void) pipeline.save(options.OutputPipelineFilePath);
+    }
+
+    // The chunks are normalized once into a temporary binary dataset file, which is read in every epoch instead of normalizing the chunks again:
+    auto normalizedDirectory = (options.CacheDirectory != Utilities::DefaultValues::CACHE_DIRECTORY) ? std::filesystem::path(options.CacheDirectory)
+                                                                                                    : std::filesystem::temp_directory_path();
+    TemporaryFile normalizedFile{normalizedDirectory / ("normalized_" + std::to_string(::getpid()) + "_" + std::to_string(splitSeed) + ".bin")};
+    if (options.DebugOutput) {
+      std::cout << "Normalize the data into \"" << normalizedFile.path.string() << "\"..." << std::endl;
+    }
+    {
+      Utilities::BinaryDatasetWriter writer(normalizedFile.path.string(), inputFileHeader, reader.getNumberOfRows(), options.NumberOfInputVariables,
+                                            options.NumberOfOutputVariables);
+      if (!writer.isOpen()) {
+        throw std::runtime_error("unable to create the file of the normalized data in \"" + normalizedDirectory.string() + "\"");
+      }
+      forEachChunk(true, [&writer](Dataset& rows, uint64_t firstRow) {
+        if (!writer.writeRows(firstRow, rows)) {
+          throw std::runtime_error("unable to write the normalized data");
+        }
+      });
+      if (!writer.finish(pipeline.getNormalizedValueRanges())) {
+        throw std::runtime_error("unable to write the normalized data");
+      }
+    }
+
+    Utilities::BinaryDatasetReader normalizedReader(normalizedFile.path.string(), options.NumberOfInputVariables, options.NumberOfOutputVariables);
+    if (!normalizedReader.isOpen()) {
+      throw std::runtime_error("unable to read the normalized data");
+    }
+    ChunkIterator forEachNormalizedChunk = [&normalizedReader, numberOfRowsPerChunk](ChunkFunction const& function) {
+      for (uint64_t firstRow = 0; firstRow < normalizedReader.getNumberOfRows(); firstRow += numberOfRowsPerChunk) {
+        auto chunk = normalizedReader.readRows(firstRow, std::min(numberOfRowsPerChunk, normalizedReader.getNumberOfRows() - firstRow));
+        if (!chunk) {
+          throw std::runtime_error("unable to read the normalized data");
+        }
+        // The chunk is trained with, so its column-major buffer is replaced by row-major matrices:
+        *chunk = chunk->contiguous();
+        function(*chunk, firstRow);
+      }
+    };
+    if (!options.CompactStorageFormat) {
+      return performChunkedRequest(reader.getNumberOfRows(), forEachNormalizedChunk, forEachNormalizedChunk);
+    }
+
+    // The normalized data is only read once for the training, the chunks are encoded into a compact dataset, whose rows are decoded batch by batch.
+    // The evaluation and the output files still use the exact normalized chunks:
+    if (options.DebugOutput) {
+      std::cout << "Encode " << reader.getNumberOfRows() << " data points to the compact storage..." << std::endl;
+    }
+    auto compactData = Dataset::CreateCompact(static_cast<int64_t>(reader.getNumberOfRows()), options.NumberOfInputVariables,
+                                              options.NumberOfOutputVariables, createCompactEncoding(), options.Precision);
+    forEachNormalizedChunk([&compactData](Dataset& rows, uint64_t firstRow) {
+      auto compactRows = compactData.slice(firstRow, firstRow + rows.size());
+      compactRows.setInputs(rows.inputs());
+      compactRows.setOutputs(rows.outputs());
+    });
+    ChunkIterator forEachCompactChunk = [&compactData, numberOfRowsPerChunk](ChunkFunction const& function) {
+      // The compact chunks have the same rows as the chunks of the file, so they are split the same way:
+      for (uint64_t firstRow = 0; firstRow < compactData.size(); firstRow += numberOfRowsPerChunk) {
+        auto rows = compactData.slice(firstRow, std::min<uint64_t>(firstRow + numberOfRowsPerChunk, compactData.size()));
+        function(rows, firstRow);
+      }
+    };
+    return performChunkedRequest(reader.getNumberOfRows(), forEachNormalizedChunk, forEachCompactChunk);
+  } catch (std::runtime_error const& error) {
+    std::cout << "\nStop execution (" << error.what() << ")." << std::endl;
+    return false;
+  }
+}
+
+bool Logic::performChunkedRequest(uint64_t numberOfRows, ChunkIterator const& forEachChunk, ChunkIterator const& forEachChunkToTrain)
+{
+  try {
+    if (!configureNetwork()) {
+      return false;
+    }
+
+    // The split into training and validation data is decided once for all rows (one bit per row), so that the chunks are split the same way in
+    // every epoch and as the data in memory (see splitDataRandomly):
+    auto trainingPercentage = options.ValidateAfterTraining ? 100.0 - options.ValidationPercentage : 100.0;
+    auto trainingRows = Utilities::DataSplitter::getTrainingRowsRandomly(numberOfRows, trainingPercentage, splitSeed);
+
+    // The chunks are preprocessed in double precision. The network is trained with the data in the precision of the user, the evaluation and
+    // the output files use the data in double precision (the region of a mixed scaling is decided with the exact normalized values):
+    auto createPartIterator = [&trainingRows](ChunkIterator const& forEachChunk, std::optional<bool> trainingPart,
+                                              torch::ScalarType dataType) -> DataPartIterator {
+      return [&forEachChunk, &trainingRows, trainingPart, dataType](DataPartFunction const& function) {
+        forEachChunk([&function, &trainingRows, trainingPart, dataType](Dataset& chunk, uint64_t firstRow) {
+          auto rows = chunk.to(dataType);
+          if (!trainingPart) {
+            function(rows);
+            return;
+          }
+          auto data = Utilities::DataSplitter::splitDataWithTrainingRows(rows, firstRow, trainingRows);
+          function(*trainingPart ? data.first : data.second);
+        });
+      };
+    };
+    auto forEachRow = createPartIterator(forEachChunk, std::nullopt, TORCH_DATA_TYPE);
+    auto forEachTrainingRow = createPartIterator(forEachChunk, true, TORCH_DATA_TYPE);
+    auto forEachValidationRow = createPartIterator(forEachChunk, false, TORCH_DATA_TYPE);
+    auto forEachRowToTrain = createPartIterator(forEachChunkToTrain, std::nullopt, options.Precision);
+    auto forEachTrainingRowToTrain = createPartIterator(forEachChunkToTrain, true, options.Precision);
+
+    if (options.DebugOutput) {
+      std::cout << "Start the training..." << std::endl;
+    }
+
+    if (numberOfRows > 0 && trainingPercentage > 0.0) {
+      bool trained = options.ValidateAfterTraining ? trainNetwork(forEachTrainingRowToTrain, forEachValidationRow) : trainNetwork(forEachRowToTrain, nullptr);
+      if (!trained) {
+        return false;
+      }
+    }
+
+    if (options.DebugOutput) {
+      std::cout << "\nTraining finished." << std::endl;
+    }
+
+    network->eval();
+
+    if (options.OutputNetworkParameters != Utilities::DefaultValues::OUTPUT_NETWORK_PARAMETERS) {
+      torch::save(network, options.OutputNetworkParameters);
+    }
+
+    // The output files are written chunk by chunk:
+    auto saveToFile = [&forEachRow](std::function<void(Dataset const& part, bool append)> const& saveFunction) {
+      bool append = false;
+      forEachRow([&saveFunction, &append](Dataset const& part) {
+        saveFunction(part, append);
+        append = append || !part.empty();
+      });
+    };
+
+    if (options.OutputValuesFilePath != Utilities::DefaultValues::OUTPUT_VALUE) {
+      saveToFile([this](Dataset const& part, bool append) { saveValuesToFile(part, options.OutputValuesFilePath, append); });
+    }
+
+    if (options.OutputDiffFilePath != Utilities::DefaultValues::OUTPUT_DIFF) {
+      saveToFile([this](Dataset const& part, bool append) { saveDiffToFile(part, options.OutputDiffFilePath, false, append); });
+    }
+
+    if (options.OutputRelativeDiffFilePath != Utilities::DefaultValues::OUTPUT_RELATIVE_DIFF) {
+      saveToFile([this](Dataset const& part, bool append) { saveDiffToFile(part, options.OutputRelativeDiffFilePath, true, append); });
+    }
+
+    if (options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH) {
+      Utilities::FileParser::SaveProgressData(trainingProgress, options.SaveProgressFilePath);
+    }
+
+    // Output behaviour of network (only the R2 score which can be calculated chunk by chunk):
+    if (options.PrintBehaviour) {
+      std::cout << std::endl;
+      if (options.ValidateAfterTraining) {
+        std::cout << "R2 score alternate (training): " << analyzer->calculateR2ScoreAlternate(forEachTrainingRow) << std::endl;
+        std::cout << "R2 score alternate (validation): " << analyzer->calculateR2ScoreAlternate(forEachValidationRow) << std::endl;
+      }
+      std::cout << "R2 score alternate (all): " << analyzer->calculateR2ScoreAlternate(forEachRow) << std::endl;
+
+      if (options.ValidateAfterTraining) {
+        std::cout << "\nTraining set:" << std::endl;
+        forEachTrainingRow([this](Dataset const& part) { outputBehaviour(part); });
+        std::cout << "\nValidation set:" << std::endl;
+        forEachValidationRow([this](Dataset const& part) { outputBehaviour(part); });
+      } else {
+        forEachRow([this](Dataset const& part) { outputBehaviour(part); });
+      }
+    }
+  } catch (std::runtime_error const& error) {
+    std::cout << "\nStop execution (" << error.what() << ")." << std::endl;
+    return false;
+  }
+
+  if (options.InteractiveMode) {
+    performInteractiveMode();
+  }
+
+  return true;
+}
+
+std::shared_ptr<Utilities::CompactEncoding const> Logic::createCompactEncoding() const
+{
+  // The normalized values are encoded relative to their known ranges:
+  return std::make_shared<Utilities::CompactEncoding const>(*options.CompactStorageFormat, pipeline.getNormalizedValueRanges());
+}
+
+bool Logic::loadCheckpoint()
+{
+  splitSeed = options.RNGSeed ? *options.RNGSeed : std::random_device()();
+  if (options.ResumeFilePath == Utilities::DefaultValues::RESUME_FILE_PATH) {
+    return true;
+  }
+
+  if (options.DebugOutput) {
+    std::cout << "Read checkpoint..." << std::endl;
+  }
+
+  try {
+    resumeArchive.emplace();
+    resumeArchive->load_from(options.ResumeFilePath);
+
+    torch::Tensor version, storedSplitSeed;
+    resumeArchive->read("version", version);
+    if (version.numel() != 1 || version.item<int64_t>() != CHECKPOINT_FORMAT_VERSION) {
+      throw std::runtime_error("unsupported version of the checkpoint");
+    }
+    // The training continues with the same split into training and validation data:
+    resumeArchive->read("splitSeed", storedSplitSeed);
+    if (storedSplitSeed.numel() != 1) {
+      throw std::runtime_error("invalid seed of the split into training and validation data");
+    }
+    splitSeed = static_cast<uint64_t>(storedSplitSeed.item<int64_t>());
+  } catch (std::exception const& e) {
+    std::cout << "Error: Could not read the checkpoint \"" << options.ResumeFilePath << "\": " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool Logic::configureNetwork()
+{
+  if (options.DebugOutput) {
+    std::cout << "Configure network..." << std::endl;
+  }
+
+  network = createNetwork();
+  analyzer = std::make_unique<NetworkAnalyzer>(network, pipeline);
+
+  if (options.Optimizer == Utilities::OptimizerType::LevenbergMarquardt) {
+    uint64_t numberOfParameters = 0;
+    for (auto const& parameter : network->parameters()) {
+      numberOfParameters += static_cast<uint64_t>(parameter.numel());
+    }
+    auto memoryUsageInMB = LevenbergMarquardt::GetMemoryUsageInBytes(numberOfParameters) / BYTES_PER_MB;
+    if (memoryUsageInMB > options.MemoryLimitInMB.value_or(LEVENBERG_MARQUARDT_MEMORY_WARNING_IN_MB)) {
+      std::cout << "[Warning] Levenberg-Marquardt needs about " << memoryUsageInMB << " MiB for the " << numberOfParameters << " parameters of the network, " <<
+                   "which may not fit in memory. Reduce the number of layers (--layers) or nodes (--nodes)." << std::endl;
+    }
+  }
+
+  // Load pre-trained weights (which may have been saved with another precision):
+  if (options.InputNetworkParameters != Utilities::DefaultValues::INPUT_NETWORK_PARAMETERS) {
+    torch::load(network, options.InputNetworkParameters);
+    network->to(getNetworkDataType());
+  }
+
+  if (resumeArchive) {
+    try {
+      torch::serialize::InputArchive networkArchive{};
+      resumeArchive->read("network", networkArchive);
+      network->load(networkArchive);
+    } catch (std::exception const& e) {
+      std::cout << "Error: The weights of the checkpoint \"" << options.ResumeFilePath << "\" do not match the network: " << e.what() << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Network Logic::createNetwork() const
+{
+  auto networkConfiguration = std::vector<uint32_t>();
+  for (uint32_t i = 0; i < options.NumberOfLayers; ++i) {
+    networkConfiguration.push_back(options.NumberOfNodesPerLayer);
+  }
+
+  return Network{options.NumberOfInputVariables, options.NumberOfOutputVariables, networkConfiguration, getNetworkDataType()};
+}
+
+torch::ScalarType Logic::getNetworkDataType() const
+{
+  // bfloat16 is only used to store the data. The network keeps float32 parameters and computes in float32, because LibTorch has no
+  // bfloat16 matrix multiplication on the CPU:
+  return (options.Precision == torch::kBFloat16) ? torch::kFloat : options.Precision;
+}
+
+bool Logic::loadPreprocessedData(Dataset& data)
+{
+  // A resumed training normalizes the data with the transform pipeline of the checkpoint, which is not part of the cache key, so the cache
+  // is neither read nor written then:
+  std::optional<Utilities::DatasetCache> cache{};
+  if (options.CacheDirectory != Utilities::DefaultValues::CACHE_DIRECTORY && !resumeArchive) {
+    if (options.DebugOutput) {
+      std::cout << "Look up preprocessed data in the cache..." << std::endl;
+    }
+    cache.emplace(options.CacheDirectory, options);
+
+    if (auto cachedDataset = cache->load()) {
+      if (options.DebugOutput) {
+        std::cout << "Use preprocessed data from the cache." << std::endl;
+      }
+      data = cachedDataset->data;
+      inputFileHeader = cachedDataset->fileHeader;
+      pipeline = cachedDataset->pipeline;
+      minMax = pipeline.getMinMax();
+      mixedScalingMinMax = pipeline.getMixedMinMax();
+      return true;
+    }
+  }
+
+  std::optional<MinMaxValues> unscaledMinMax{};
+  if (!readInputData(data, unscaledMinMax)) {
+    return false;
+  }
+
+  if (!preprocessData(data, unscaledMinMax)) {
+    return false;
+  }
+
+  if (cache) {
+    if (options.DebugOutput) {
+      std::cout << "Store preprocessed data in the cache..." << std::endl;
+    }
+    cache->store(Utilities::PreprocessedDataset{data, inputFileHeader, pipeline});
+  }
 
-namespace NeuralNetwork {
+  return true;
+}
 
-bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
+bool Logic::readInputData(Dataset& data, std::optional<MinMaxValues>& unscaledMinMax)
 {
-  options = user_options;
-
   if (options.DebugOutput) {
     std::cout << "Read input file..." << std::endl;
   }
-  auto dataOpt = Utilities::FileParser::ParseInputFile(options.InputDataFilePath, options.NumberOfInputVariables,
-    options.NumberOfOutputVariables, inputFileHeader);
-  if (!dataOpt) {
+  std::optional<Dataset> inputData{};
+  if (Utilities::BinaryDataset::IsBinaryDatasetFile(options.InputDataFilePath)) {
+    MinMaxValues binaryMinMax{};
+    inputData = Utilities::BinaryDataset::Load(options.InputDataFilePath, options.NumberOfInputVariables, options.NumberOfOutputVariables,
+                                               inputFileHeader, binaryMinMax);
+    unscaledMinMax = binaryMinMax;
+
+    // The scaling and normalization change every value. A binary dataset file is mapped read-only, so it is copied once into row-major
+    // matrices, which are transformed in place and used for the training. Reading the mapping leaves its pages shared with other processes,
+    // the mapping is released with the last reference to it:
+    if (inputData) {
+      *inputData = inputData->clone();
+    }
+  } else {
+    // The statistics of the columns are collected while the file is parsed:
+    Utilities::DatasetStatistics statistics{};
+    inputData = Utilities::FileParser::ParseInputFile(options.InputDataFilePath, options.NumberOfInputVariables,
+      options.NumberOfOutputVariables, inputFileHeader, static_cast<uint32_t>(options.NumberOfThreads), &statistics);
+    unscaledMinMax = statistics.getMinMax();
+  }
+  if (!inputData) {
     return false;
   }
 
-  useMixedScaling = options.LogLinScaling || options.LogSqrtScaling;
-  torch::set_num_threads(options.NumberOfThreads);
+  data = std::move(*inputData);
+  return true;
+}
 
-  if (options.RNGSeed) {
-    torch::manual_seed(*options.RNGSeed);
+bool Logic::reloadPreprocessedData(Dataset& data)
+{
+  std::optional<MinMaxValues> unscaledMinMax{};
+  if (!readInputData(data, unscaledMinMax)) {
+    return false;
   }
 
+  // The pipeline is already determined, so the values are only transformed:
+  pipeline.forward(data, static_cast<uint32_t>(options.NumberOfThreads));
+  return true;
+}
+
+bool Logic::preprocessData(Dataset& data, std::optional<MinMaxValues> const& unscaledMinMax)
+{
   if (options.DebugOutput) {
     std::cout << "Scale the output tensors..." << std::endl;
   }
 
-  if (options.LogScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
-      (void) inputTensor;
-      Utilities::DataProcessor::ScaleLogarithmic(outputTensor);
-    }
-  } else if (options.SqrtScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
-      (void) inputTensor;
-      Utilities::DataProcessor::ScaleSquareRoot(outputTensor);
+  auto numberOfThreads = static_cast<uint32_t>(options.NumberOfThreads);
+  pipeline.scale(data, numberOfThreads);
+
+  if (options.DebugOutput) {
+    std::cout << "Get min/max values..." << std::endl;
+  }
+
+  bool minMaxValid = determineMinMaxValues([this, &data, &unscaledMinMax, numberOfThreads]() {
+    if (useMixedScaling) {
+      Utilities::DataProcessor::CalculateMixedMinMax(data, options.MixedScalingInputVariable, options.MixedScalingThreshold, mixedScalingMinMax,
+                                                     numberOfThreads);
+    } else if (unscaledMinMax && !options.LogScaling && !options.SqrtScaling) {
+      // The min/max values of the input file (stored in a binary dataset file or collected by the parser) are only valid for unscaled data:
+      minMax = *unscaledMinMax;
+    } else {
+      Utilities::DataProcessor::CalculateMinMax(data, minMax, numberOfThreads);
     }
-  } else if (options.LogLinScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
-      if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= options.MixedScalingThreshold) {
-        Utilities::DataProcessor::ScaleLogarithmic(outputTensor);
-      }
+  });
+  if (!minMaxValid) {
+    return false;
+  }
+
+  if (options.DebugOutput) {
+    std::cout << "Normalize values..." << std::endl;
+  }
+
+  pipeline.normalize(data, numberOfThreads);
+
+  return true;
+}
+
+bool Logic::determineMinMaxValues(std::function<void()> const& calculateMinMax)
+{
+  if (resumeArchive) {
+    // The checkpoint contains the transform pipeline (with the min/max values) of the interrupted training:
+    try {
+      torch::serialize::InputArchive pipelineArchive{};
+      resumeArchive->read("pipeline", pipelineArchive);
+      pipeline = Utilities::TransformPipeline::Read(pipelineArchive);
+    } catch (std::exception const& e) {
+      std::cout << "Error: The checkpoint \"" << options.ResumeFilePath << "\" contains no valid transform pipeline: " << e.what() << std::endl;
+      return false;
     }
-  } else if (options.LogSqrtScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
-      if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= options.MixedScalingThreshold) {
-        Utilities::DataProcessor::ScaleLogarithmic(outputTensor);
-      } else {
-        Utilities::DataProcessor::ScaleSquareRoot(outputTensor);
-      }
+    if (!pipeline.matchesOptions(options)) {
+      std::cout << "Error: The checkpoint \"" << options.ResumeFilePath << "\" was created for other scaling options or another number of variables." << std::endl;
+      return false;
     }
+    minMax = pipeline.getMinMax();
+    mixedScalingMinMax = pipeline.getMixedMinMax();
+    return true;
   }
 
-  if (options.DebugOutput) {
-    std::cout << "Get min/max values..." << std::endl;
+  if (options.InputPipelineFilePath != Utilities::DefaultValues::INPUT_PIPELINE_FILE_PATH) {
+    // The pipeline contains the min/max values and the precomputed normalization:
+    auto pipelineFromFile = Utilities::TransformPipeline::Load(options.InputPipelineFilePath);
+    if (!pipelineFromFile) {
+      return false;
+    }
+    if (!pipelineFromFile->matchesOptions(options)) {
+      std::cout << "Error: The transform pipeline \"" << options.InputPipelineFilePath << "\" was created for other scaling options or another number of variables." << std::endl;
+      return false;
+    }
+    pipeline = *pipelineFromFile;
+    minMax = pipeline.getMinMax();
+    mixedScalingMinMax = pipeline.getMixedMinMax();
+    return true;
   }
 
-  // Get min/max values
   bool minMaxInputtedByUser = options.InputMinMaxFilePath != Utilities::DefaultValues::INPUT_MIN_MAX_FILE_PATH;
   if (minMaxInputtedByUser) {
     if (useMixedScaling) {
@@ -81,11 +847,7 @@ bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
       minMax = *minMaxFromFile;
     }
   } else {
-    if (useMixedScaling) {
-      Utilities::DataProcessor::CalculateMixedMinMax(*dataOpt, options.MixedScalingInputVariable, options.MixedScalingThreshold, mixedScalingMinMax);
-    } else {
-      Utilities::DataProcessor::CalculateMinMax(*dataOpt, minMax);
-    }
+    calculateMinMax();
   }
 
   if (!minMaxValuesAreValid()) {
@@ -97,165 +859,281 @@ bool Logic::performUserRequest(Utilities::ProgramOptions const& user_options)
     return false;
   }
 
-  if (options.DebugOutput) {
-    std::cout << "Normalize values..." << std::endl;
-  }
-
-  // Normalize
   if (useMixedScaling) {
-    for (auto& [inputTensor, outputTensor] : *dataOpt) {
-      if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= options.MixedScalingThreshold) {
-        Utilities::DataProcessor::Normalize(outputTensor, mixedScalingMinMax.first.second, -1.0, 0.0); // TODO check if overlap is a problem
-      } else {
-        Utilities::DataProcessor::Normalize(outputTensor, mixedScalingMinMax.second.second, 0.0, 1.0);
-      }
-      Utilities::DataProcessor::Normalize(inputTensor, mixedScalingMinMax.first.first, 0.0, 1.0);
-    }
+    pipeline.setMixedMinMax(mixedScalingMinMax);
   } else {
-    Utilities::DataProcessor::Normalize(*dataOpt, minMax, 0.0, 1.0);  // TODO let user control normalization
+    pipeline.setMinMax(minMax);
   }
 
-  // Calculate denormalized mixed scaling threshold value:
-  if (useMixedScaling) {
-    auto tempInputTensor = dataOpt->front().first.clone();
-    tempInputTensor[options.MixedScalingInputVariable] = options.MixedScalingThreshold;
+  return true;
+}
 
-    Utilities::DataProcessor::Normalize(tempInputTensor, mixedScalingMinMax.first.first, 0.0, 1.0);
-    normalizedMixedScalingThreshold = tempInputTensor[options.MixedScalingInputVariable].item<TensorDataType>();
+bool Logic::convertInputFile()
+{
+  if (options.DebugOutput) {
+    std::cout << "Convert input file..." << std::endl;
   }
 
-  if (options.OutputMinMaxFilePath != Utilities::DefaultValues::OUTPUT_MIN_MAX_FILE_PATH) {
-    saveMinMaxToFile();
+  // With a memory limit, the file is converted chunk by chunk (the values of a chunk and a copy of one of its columns are kept in memory):
+  auto maximumRowsPerChunk = Utilities::FileParser::UNLIMITED_ROWS_PER_CHUNK;
+  if (options.MemoryLimitInMB) {
+    auto bytesPerRow = (options.NumberOfInputVariables + options.NumberOfOutputVariables + 1) * sizeof(TensorDataType);
+    maximumRowsPerChunk = std::max<uint64_t>(1, (*options.MemoryLimitInMB * BYTES_PER_MB) / bytesPerRow);
   }
 
-  if (options.DebugOutput) {
-    std::cout << "Configure network..." << std::endl;
-  }
+  std::unique_ptr<Utilities::BinaryDatasetWriter> writer{};
+  Utilities::DatasetStatistics statistics{};
+  auto createWriter = [this, &writer](uint64_t numberOfRows) {
+    writer = std::make_unique<Utilities::BinaryDatasetWriter>(options.ConvertInputFilePath, inputFileHeader, numberOfRows,
+                                                              options.NumberOfInputVariables, options.NumberOfOutputVariables);
+    return writer->isOpen();
+  };
 
-  auto networkConfiguration = std::vector<uint32_t>();
-  for (uint32_t i = 0; i < options.NumberOfLayers; ++i) {
-    networkConfiguration.push_back(options.NumberOfNodesPerLayer);
-  }
+  auto numberOfRows = Utilities::FileParser::ParseInputFileInChunks(options.InputDataFilePath, options.NumberOfInputVariables, options.NumberOfOutputVariables,
+    inputFileHeader, static_cast<uint32_t>(options.NumberOfThreads), maximumRowsPerChunk,
+    [&writer, &createWriter, &statistics](Dataset const& chunk, Utilities::DatasetStatistics const& chunkStatistics, uint64_t firstRow, uint64_t numberOfRows) {
+      if (!writer && !createWriter(numberOfRows)) {
+        return false;
+      }
 
-  network = Network{options.NumberOfInputVariables, options.NumberOfOutputVariables, networkConfiguration};
-  analyzer = std::make_unique<NetworkAnalyzer>(network, [this](auto inTensor, auto outTensor, auto limitValues) {
-    denormalizeOutputTensor(inTensor, outTensor, limitValues);
-  }, [this](auto inTensor, auto outTensor) {
-    unscaleOutputTensor(inTensor, outTensor);
-  });
+      // The statistics are collected while the file is parsed:
+      statistics.merge(chunkStatistics);
 
-  // Load pre-trained weights:
-  if (options.InputNetworkParameters != Utilities::DefaultValues::INPUT_NETWORK_PARAMETERS) {
-    torch::load(network, options.InputNetworkParameters);
+      return writer->writeRows(firstRow, chunk);
+    });
+  if (!numberOfRows) {
+    return false;
   }
 
-  std::pair<DataVector, DataVector> data;
-
-  if (options.ValidateAfterTraining) {
-    data = Utilities::DataSplitter::splitDataRandomly(*dataOpt, 100.0 - options.ValidationPercentage);
-  } else {
-    data = std::make_pair(*dataOpt, DataVector());
+  // A file without data rows:
+  if (!writer && !createWriter(0)) {
+    return false;
   }
 
-  if (options.BatchVariable.has_value()) {
-    useBatchTraining = true;
+  minMax = statistics.getMinMax();
+  if (!writer->finish(minMax)) {
+    return false;
+  }
 
-    batchedTrainingData = Utilities::DataSplitter::splitDataIntoBatches(data.first, options.BatchVariable.value());
+  std::cout << "Converted " << *numberOfRows << " data points to the binary dataset \"" << options.ConvertInputFilePath << "\"." << std::endl;
+  return true;
+}
 
-    if (options.DebugOutput) {
-      std::cout << "Split training data (" << data.first.size() << " data points) into " << batchedTrainingData.size() << " batches." << std::endl;
-      std::cout << "Size of first batch: " << batchedTrainingData.begin()->second.size() << std::endl;
-    }
+bool Logic::trainNetwork(Dataset const& data, Dataset const& validationData)
+{
+  if (data.empty()) {
+    return true;
   }
 
-  if (options.DebugOutput) {
-    std::cout << "Start the training..." << std::endl;
+  DataPartIterator forEachValidationPart = nullptr;
+  if (!validationData.empty()) {
+    forEachValidationPart = [&validationData](DataPartFunction const& function) {
+      function(validationData);
+    };
   }
 
-  trainNetwork(data.first);
-
-  if (options.DebugOutput) {
-    std::cout << "\nTraining finished." << std::endl;
-  }
+  return trainNetwork([&data](DataPartFunction const& function) {
+    function(data);
+  }, forEachValidationPart);
+}
 
-  network->eval();
+bool Logic::trainNetwork(DataPartIterator const& forEachPart, DataPartIterator const& forEachValidationPart)
+{
+  auto const& numberOfEpochs = options.NumberOfEpochs;
+  bool saveProgress = options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH;
 
-  if (options.OutputNetworkParameters != Utilities::DefaultValues::OUTPUT_NETWORK_PARAMETERS) {
-    torch::save(network, options.OutputNetworkParameters);
-  }
+  Optimizer optimizer(network->parameters(), options);
+  std::mt19937_64 shuffleGenerator(options.RNGSeed ? *options.RNGSeed : std::random_device()());
 
-  if (options.OutputValuesFilePath != Utilities::DefaultValues::OUTPUT_VALUE) {
-    saveValuesToFile(*dataOpt, options.OutputValuesFilePath);
+  std::optional<LevenbergMarquardt> levenbergMarquardt{};
+  if (options.Optimizer == Utilities::OptimizerType::LevenbergMarquardt) {
+    levenbergMarquardt.emplace(network);
   }
 
-  if (options.OutputDiffFilePath != Utilities::DefaultValues::OUTPUT_DIFF) {
-    saveDiffToFile(*dataOpt, options.OutputDiffFilePath, false);
+  size_t numberOfRows = 0;
+  if (options.Optimizer == Utilities::OptimizerType::LBFGS || options.EvaluationSampleSize > 0) {
+    forEachPart([&numberOfRows](Dataset const& part) {
+      numberOfRows += part.size();
+    });
   }
 
-  if (options.OutputRelativeDiffFilePath != Utilities::DefaultValues::OUTPUT_RELATIVE_DIFF) {
-    saveDiffToFile(*dataOpt, options.OutputRelativeDiffFilePath, true);
+  // The exact evaluations (first epoch and --evalEvery) use all training rows or --evalSample evenly spaced rows:
+  DataPartIterator forEachEvaluationPart = forEachPart;
+  if (options.EvaluationSampleSize > 0 && options.EvaluationSampleSize < numberOfRows) {
+    auto stride = numberOfRows / options.EvaluationSampleSize;
+    forEachEvaluationPart = [this, &forEachPart, stride](DataPartFunction const& function) {
+      uint64_t firstRow = 0;
+      forEachPart([this, &function, stride, &firstRow](Dataset const& part) {
+        std::vector<int64_t> rows{};
+        for (auto row = (stride - firstRow % stride) % stride; row < part.size() && (firstRow + row) / stride < options.EvaluationSampleSize; row += stride) {
+          rows.push_back(static_cast<int64_t>(row));
+        }
+        firstRow += part.size();
+        if (!rows.empty()) {
+          function(part.subset(rows));
+        }
+      });
+    };
   }
 
-  if (options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH) {
-    Utilities::FileParser::SaveProgressData(trainingProgress, options.SaveProgressFilePath);
+  // R2 of the progress records is calculated with the variances of the outputs, which do not change during the training:
+  std::vector<double> outputVariances{};
+  if (saveProgress) {
+    outputVariances = NetworkAnalyzer::calculateOutputVariances(forEachPart);
   }
 
-  // Output behaviour of network:
-  if (options.PrintBehaviour) {
-    std::cout << std::endl;
-    if (options.ValidateAfterTraining) {
-      std::cout << "R2 score (training): " << analyzer->calculateR2Score(data.first) << std::endl;
-      std::cout << "R2 score alternate (training): " << analyzer->calculateR2ScoreAlternate(data.first) << std::endl;
-      std::cout << "R2 score alternate denormalized (training): " << analyzer->calculateR2ScoreAlternateDenormalized(data.first) << std::endl;
-      std::cout << "R2 score (validation): " << analyzer->calculateR2Score(data.second) << std::endl;
-      std::cout << "R2 score alternate (validation): " << analyzer->calculateR2ScoreAlternate(data.second) << std::endl;
-      std::cout << "R2 score alternate denormalized (validation): " << analyzer->calculateR2ScoreAlternateDenormalized(data.second) << std::endl;
+  // The batches are computed by several threads, each with its own replica of the network (not used for the full-batch optimizers and for
+  // batches of a single row, e.g. with --shuffle and --batchSize 1):
+  bool usesBatches = useBatchTraining || options.BatchSize > 1;
+  bool trainsRowByRow = !usesBatches && !options.ShuffleData;
+  bool usesFullBatch = levenbergMarquardt || options.Optimizer == Utilities::OptimizerType::LBFGS;
+  std::unique_ptr<DataParallelTrainer> dataParallelTrainer{};
+  if (options.DataParallelWorkers > 1 && usesBatches && !usesFullBatch) {
+    std::vector<Network> replicas{};
+    for (uint32_t i = 1; i < options.DataParallelWorkers; ++i) {
+      replicas.push_back(createNetwork());
     }
-    std::cout << "R2 score (all): " << analyzer->calculateR2Score(*dataOpt) << std::endl;
-    std::cout << "R2 score alternate (all): " << analyzer->calculateR2ScoreAlternate(*dataOpt) << std::endl;
-    std::cout << "R2 score alternate denormalized (all): " << analyzer->calculateR2ScoreAlternateDenormalized(*dataOpt) << std::endl;
+    dataParallelTrainer = std::make_unique<DataParallelTrainer>(network, replicas);
+  }
 
-    if (options.ValidateAfterTraining) {
-      std::cout << "\nTraining set:" << std::endl;
-      outputBehaviour(data.first);
-      std::cout << "\nValidation set:" << std::endl;
-      outputBehaviour(data.second);
-    } else {
-      outputBehaviour(*dataOpt);
+  // The rows are trained by several threads at the same time, the first one with the network, the others with replicas which share its parameters:
+  std::unique_ptr<HogwildTrainer> hogwildTrainer{};
+  if (options.HogwildThreads > 1 && trainsRowByRow && !usesFullBatch) {
+    std::vector<Network> replicas{};
+    for (uint32_t i = 1; i < options.HogwildThreads; ++i) {
+      replicas.push_back(createNetwork());
     }
+    hogwildTrainer = std::make_unique<HogwildTrainer>(network, replicas, options);
   }
 
-  if (options.InteractiveMode) {
-    performInteractiveMode();
+  std::unique_ptr<AsyncValidator> validator{};
+  if (options.ValidationInterval > 0 && forEachValidationPart) {
+    validator = std::make_unique<AsyncValidator>(network, createNetwork(), forEachValidationPart, pipeline);
   }
+  uint32_t numberOfTrainedEpochs = 0;
 
-  return true;
-}
+  // Besides the exact evaluations, the errors are taken from the previous training pass (accumulated before each step):
+  ErrorAccumulator trainingErrors{};
+  ErrorAccumulator evaluationErrors{};
+  double lastMeanError = 0.0;
+  double currentMeanError = 0.0;
 
-void Logic::trainNetwork(DataVector const& data)
-{
-  if (data.empty()) {
-    return;
-  }
+  bool continueTraining = true;
+  uint32_t numberOfDeteriorationsInRow = 0;
 
-  auto const& numberOfEpochs = options.NumberOfEpochs;
-  bool saveProgress = options.SaveProgressFilePath != Utilities::DefaultValues::PROGRESS_FILE_PATH;
+  uint32_t firstEpoch = 1;
+  auto start = std::chrono::steady_clock::now();
+
+  // Throughput of the training passes (without the evaluations):
+  uint64_t numberOfTrainedRows = 0;
+  std::chrono::steady_clock::duration trainingTime{};
 
-  torch::optim::SGD optimizer(network->parameters(), options.LearnRate);
+  if (resumeArchive) {
+    // Everything which influences the following epochs is restored, so that the training continues as if it had not been interrupted:
+    try {
+      torch::Tensor state, meanError, generatorState;
+      resumeArchive->read("state", state);
+      resumeArchive->read("meanError", meanError);
+      resumeArchive->read("shuffleGenerator", generatorState);
+      if (state.numel() != 5 || meanError.numel() != 1) {
+        throw std::runtime_error("invalid state of the training");
+      }
+      auto stateValues = state.to(torch::kInt64).contiguous();
+      auto statePointer = stateValues.data_ptr<int64_t>();
+      firstEpoch = static_cast<uint32_t>(statePointer[0]);
+      numberOfTrainedEpochs = static_cast<uint32_t>(statePointer[1]);
+      numberOfDeteriorationsInRow = static_cast<uint32_t>(statePointer[2]);
+      continueTraining = statePointer[3] != 0;
+      start -= std::chrono::milliseconds(statePointer[4]);
+      currentMeanError = meanError.item<double>();
+      setState(shuffleGenerator, generatorState);
+
+      torch::serialize::InputArchive optimizerArchive{}, errorsArchive{}, progressArchive{};
+      resumeArchive->read("optimizer", optimizerArchive);
+      optimizer.read(optimizerArchive);
+      resumeArchive->read("trainingErrors", errorsArchive);
+      trainingErrors.read(errorsArchive);
+      resumeArchive->read("progress", progressArchive);
+      trainingProgress = readProgress(progressArchive);
+
+      if (levenbergMarquardt) {
+        torch::serialize::InputArchive levenbergMarquardtArchive{};
+        resumeArchive->read("levenbergMarquardt", levenbergMarquardtArchive);
+        levenbergMarquardt->read(levenbergMarquardtArchive);
+      }
+      if (validator) {
+        torch::serialize::InputArchive validatorArchive{};
+        resumeArchive->read("validator", validatorArchive);
+        validator->read(validatorArchive);
+      }
+    } catch (std::exception const& e) {
+      std::cout << "Error: Could not restore the training from the checkpoint \"" << options.ResumeFilePath << "\": " << e.what() << std::endl;
+      return false;
+    }
+    resumeArchive.reset();
 
-  auto lastMeanError = analyzer->calculateMeanSquaredError(data);
-  auto currentMeanError = lastMeanError;
+    if (options.DebugOutput) {
+      std::cout << "Continue the training with epoch " << firstEpoch << "." << std::endl;
+    }
+  }
 
-  bool continueTraining = true;
-  uint32_t numberOfDeteriorationsInRow = 0;
+  // A checkpoint contains the state before the given epoch:
+  std::optional<CheckpointWriter> checkpointWriter{};
+  if (options.CheckpointInterval > 0) {
+    checkpointWriter.emplace(options.CheckpointFilePath);
+  }
+  auto writeCheckpoint = [&](uint32_t const nextEpoch) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    torch::serialize::OutputArchive archive{};
+    archive.write("version", torch::tensor(std::vector<int64_t>{CHECKPOINT_FORMAT_VERSION}, torch::kInt64));
+    archive.write("splitSeed", torch::tensor(std::vector<int64_t>{static_cast<int64_t>(splitSeed)}, torch::kInt64));
+    archive.write("state", torch::tensor(std::vector<int64_t>{nextEpoch, numberOfTrainedEpochs, numberOfDeteriorationsInRow, continueTraining,
+                                                              static_cast<int64_t>(elapsed.count())}, torch::kInt64));
+    archive.write("meanError", torch::tensor(std::vector<double>{currentMeanError}, torch::kDouble));
+    archive.write("shuffleGenerator", toTensor(shuffleGenerator));
+
+    torch::serialize::OutputArchive pipelineArchive{}, networkArchive{}, optimizerArchive{}, errorsArchive{}, progressArchive{};
+    pipeline.write(pipelineArchive);
+    archive.write("pipeline", pipelineArchive);
+    network->save(networkArchive);
+    archive.write("network", networkArchive);
+    optimizer.write(optimizerArchive);
+    archive.write("optimizer", optimizerArchive);
+    trainingErrors.write(errorsArchive);
+    archive.write("trainingErrors", errorsArchive);
+    writeProgress(progressArchive, trainingProgress);
+    archive.write("progress", progressArchive);
+
+    if (levenbergMarquardt) {
+      torch::serialize::OutputArchive levenbergMarquardtArchive{};
+      levenbergMarquardt->write(levenbergMarquardtArchive);
+      archive.write("levenbergMarquardt", levenbergMarquardtArchive);
+    }
+    if (validator) {
+      torch::serialize::OutputArchive validatorArchive{};
+      validator->write(validatorArchive);
+      archive.write("validator", validatorArchive);
+    }
 
-  auto start = std::chrono::steady_clock::now();
+    checkpointWriter->write(archive);
+  };
 
-  for (uint32_t epoch = 1; epoch <= numberOfEpochs || continueTraining; ++epoch) {
+  for (uint32_t epoch = firstEpoch; epoch <= numberOfEpochs || continueTraining; ++epoch) {
     auto elapsed = std::chrono::duration_cast<TimeoutDuration>(std::chrono::steady_clock::now() - start);
     auto remaining = ((elapsed / std::max(epoch - 1, 1u)) * (numberOfEpochs - epoch + 1));
+    bool evaluate = epoch == 1 || trainingErrors.empty() || (options.EvaluationInterval > 0 && (epoch - 1) % options.EvaluationInterval == 0);
+    if (evaluate) {
+      evaluationErrors.reset();
+      analyzer->accumulateErrors(forEachEvaluationPart, evaluationErrors);
+    }
+    auto const& errors = evaluate ? evaluationErrors : trainingErrors;
+
     lastMeanError = currentMeanError;
-    currentMeanError = analyzer->calculateMeanSquaredError(data);
+    currentMeanError = errors.getMeanSquaredError();
+    if (epoch == 1) {
+      lastMeanError = currentMeanError;
+    }
 
     if (lastMeanError - currentMeanError < options.Epsilon) {
       ++numberOfDeteriorationsInRow;
@@ -266,8 +1144,13 @@ void Logic::trainNetwork(DataVector const& data)
       numberOfDeteriorationsInRow = 0;
     }
 
+    optimizer.startEpoch(epoch, numberOfDeteriorationsInRow);
+    if (hogwildTrainer) {
+      hogwildTrainer->startEpoch(epoch, numberOfDeteriorationsInRow);
+    }
+
     if (saveProgress) {
-      auto r2score = analyzer->calculateR2ScoreAlternate(data);
+      auto r2score = errors.getR2Score(outputVariances);
       trainingProgress.emplace_back(LearnProgressDataSet{
         epoch,
         r2score,
@@ -297,39 +1180,151 @@ void Logic::trainNetwork(DataVector const& data)
       break;
     }
 
-    if (useBatchTraining) {
-      for (auto const& [identifier, batch] : batchedTrainingData) {
-        (void) identifier;
+    if (validator) {
+      (void) validator->poll();
+      if (validator->getNumberOfValidationsWithoutImprovement() > options.ValidationPatience) {
+        std::cout << "\nStop execution (the validation error did not improve " << validator->getNumberOfValidationsWithoutImprovement() << " times in a row)." << std::endl;
+        break;
+      }
+
+      // A validation is skipped, if the previous one is still running, so that the training never waits for it:
+      if (numberOfTrainedEpochs > 0 && numberOfTrainedEpochs % options.ValidationInterval == 0) {
+        (void) validator->start(numberOfTrainedEpochs);
+      }
+    }
+    ++numberOfTrainedEpochs;
 
-        optimizer.zero_grad();
+    trainingErrors.reset();
+    auto trainingStart = std::chrono::steady_clock::now();
 
-        for (auto const& [x, y] : batch) {
-          auto prediction = network->forward(x);
-          auto loss = torch::mse_loss(prediction, y);
+    if (levenbergMarquardt) {
+      if (!levenbergMarquardt->step(forEachPart, trainingErrors)) {
+        std::cout << "\nStop execution (Levenberg-Marquardt cannot reduce the error anymore)." << std::endl;
+        break;
+      }
+    } else if (options.Optimizer == Utilities::OptimizerType::LBFGS) {
+      // The closure is evaluated once per iteration (and line search step) with all training data. The loss is the mean over all rows,
+      // the gradients are accumulated slice by slice:
+      optimizer.step([this, &optimizer, &forEachPart, &trainingErrors, numberOfRows]() {
+        optimizer.zeroGrad();
+        trainingErrors.reset();
+
+        double totalLoss = 0.0;
+        forEachPart([this, &totalLoss, &trainingErrors, numberOfRows](Dataset const& part) {
+          for (size_t begin = 0; begin < part.size(); begin += ROWS_PER_FULL_BATCH_SLICE) {
+            auto slice = part.slice(begin, std::min(begin + ROWS_PER_FULL_BATCH_SLICE, part.size()));
+            auto prediction = network->forward(slice.inputs());
+            auto loss = torch::mse_loss(prediction, slice.outputs().to(prediction.scalar_type()), torch::Reduction::Sum) /
+                        static_cast<double>(numberOfRows * prediction.size(1));
+
+            loss.backward();
+            totalLoss += loss.item<double>();
+            trainingErrors.add(prediction, slice.outputs());
+          }
+        });
+
+        return torch::tensor(totalLoss, torch::kDouble);
+      });
+    } else if (useBatchTraining) {
+      // One step per batch with the sum of the losses of its rows, computed with a single forward and backward pass over the batch matrix:
+      for (auto const& batch : batchedTrainingData) {
+        optimizer.zeroGrad();
+
+        if (dataParallelTrainer) {
+          dataParallelTrainer->computeGradients(batch.inputs(), batch.outputs(), batch.getNumberOfOutputVariables(), trainingErrors);
+        } else {
+          auto prediction = network->forward(batch.inputs());
+          auto loss = torch::mse_loss(prediction, batch.outputs().to(prediction.scalar_type()), torch::Reduction::Sum) / prediction.size(1);
+          trainingErrors.add(prediction, batch.outputs());
 
           loss.backward();
         }
 
         optimizer.step();
       }
+    } else if (hogwildTrainer) {
+      forEachPart([&hogwildTrainer, &trainingErrors](Dataset const& part) {
+        hogwildTrainer->train(part, trainingErrors);
+      });
+    } else if (options.BatchSize == 1 && !options.ShuffleData) {
+      forEachPart([this, &optimizer, &trainingErrors](Dataset const& part) {
+        for (auto const& [x, y] : part) {
+          auto prediction = network->forward(x);
+
+          auto loss = torch::mse_loss(prediction, y.to(prediction.scalar_type()));
+          trainingErrors.add(prediction, y);
+
+          optimizer.zeroGrad();
+
+          loss.backward();
+          optimizer.step();
+        }
+      });
     } else {
-      for (auto const& [x, y] : data) {
-        auto prediction = network->forward(x);
+      // Each step uses a matrix of rows [batchSize, numberIn], so each layer is a single matrix multiplication.
+      // The loader gathers the next batch on a background thread during the step:
+      forEachPart([this, &optimizer, &shuffleGenerator, &trainingErrors, &dataParallelTrainer](Dataset const& part) {
+        Utilities::DataLoader loader(part, options.BatchSize, options.ShuffleData ? &shuffleGenerator : nullptr);
+        while (auto batch = loader.next()) {
+          auto const& [x, y] = *batch;
+          optimizer.zeroGrad();
+
+          if (dataParallelTrainer) {
+            // The loss is the mean over all values of the batch, as with a single thread:
+            dataParallelTrainer->computeGradients(x, y, static_cast<double>(y.numel()), trainingErrors);
+          } else {
+            auto prediction = network->forward(x);
+
+            auto loss = torch::mse_loss(prediction, y.to(prediction.scalar_type()));
+            trainingErrors.add(prediction, y);
+
+            loss.backward();
+          }
+
+          optimizer.step();
+        }
+      });
+    }
 
-        auto loss = torch::mse_loss(prediction, y);
+    trainingTime += std::chrono::steady_clock::now() - trainingStart;
+    numberOfTrainedRows += trainingErrors.getNumberOfRows();
 
-        optimizer.zero_grad();
+    if (checkpointWriter && numberOfTrainedEpochs % options.CheckpointInterval == 0) {
+      writeCheckpoint(epoch + 1);
+    }
+  }
 
-        loss.backward();
-        optimizer.step();
-      }
+  if (validator) {
+    // The final parameters are validated as well, before the best parameters are restored:
+    (void) validator->finish();
+    if (validator->getBestEpoch() != numberOfTrainedEpochs) {
+      (void) validator->start(numberOfTrainedEpochs);
+      (void) validator->finish();
+    }
+    if (validator->restoreBestParameters()) {
+      std::cout << "\nRestored the parameters after epoch " << validator->getBestEpoch() << " with the lowest validation error: " << validator->getBestError() << std::endl;
     }
   }
 
   if (options.DebugOutput) {
     std::cout << "\nTraining duration: " << formatDuration<std::chrono::milliseconds, std::chrono::hours, std::chrono::minutes, std::chrono::seconds>
       (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)) << std::endl;
+
+    auto trainingSeconds = std::chrono::duration<double>(trainingTime).count();
+    if (trainingSeconds > 0.0) {
+      std::cout << "Training throughput: " << static_cast<double>(numberOfTrainedRows) / trainingSeconds << " rows/s" << std::endl;
+    }
+  }
+
+  // The throughput of the threads shows, whether the Hogwild training scales:
+  if (hogwildTrainer) {
+    auto rowsPerSecond = hogwildTrainer->getRowsPerSecond();
+    for (size_t i = 0; i < rowsPerSecond.size(); ++i) {
+      std::cout << "Training throughput of Hogwild thread " << (i + 1) << ": " << rowsPerSecond[i] << " rows/s" << std::endl;
+    }
   }
+
+  return true;
 }
 
 void Logic::performInteractiveMode()
@@ -354,12 +1349,10 @@ void Logic::performInteractiveMode()
     }
 
     if (currentVariable >= options.NumberOfInputVariables) {
-      Utilities::DataProcessor::Normalize(inTensor, (useMixedScaling) ? mixedScalingMinMax.first.first : inputMinMax, 0.0, 1.0);
-      auto output = network->forward(inTensor);
+      pipeline.normalizeInputs(inTensor);
+      auto output = network->forward(inTensor).to(TORCH_DATA_TYPE);
       auto dOutputTensor = output.clone();
-      denormalizeOutputTensor(inTensor, dOutputTensor, false);
-
-      unscaleOutputTensor(inTensor, dOutputTensor);
+      pipeline.inverseOutputs(inTensor, dOutputTensor);
 
       std::cout << "Normalized input: ";
       for (uint32_t i = 0; i < options.NumberOfInputVariables; ++i) {
@@ -376,164 +1369,125 @@ void Logic::performInteractiveMode()
   }
 }
 
-void Logic::outputBehaviour(DataVector const& data)
+void Logic::outputBehaviour(Dataset const& data)
 {
-  for (auto const& [inputTensor, outputTensor] : data) {
-    auto prediction = network->forward(inputTensor);
-    auto loss = torch::mse_loss(prediction, outputTensor);
-
-    torch::Tensor dInputTensor = inputTensor.clone();
-    torch::Tensor dOutputTensor = outputTensor.clone();
-    torch::Tensor dPrediction = prediction.clone();
-
-    denormalizeInputTensor(dInputTensor, false);
-    denormalizeOutputTensor(inputTensor, dOutputTensor, false);
-    denormalizeOutputTensor(inputTensor, dPrediction, false);
+  if (data.empty()) {
+    return;
+  }
 
-    unscaleOutputTensor(inputTensor, dOutputTensor);
-    unscaleOutputTensor(inputTensor, dPrediction);
+  // The predictions are inferred in batches and all rows are denormalized at once before they are printed:
+  auto numberOfThreads = static_cast<uint32_t>(options.NumberOfThreads);
+  auto inputs = data.inputs().to(TORCH_DATA_TYPE).contiguous();
+  auto outputs = data.outputs().to(TORCH_DATA_TYPE).contiguous();
+  auto predictions = analyzer->predict(data);
+
+  auto dInputs = inputs.clone();
+  auto dOutputs = outputs.clone();
+  auto dPredictions = predictions.clone();
+  pipeline.denormalizeInputs(dInputs, false, numberOfThreads);
+  pipeline.inverseOutputs(inputs, dOutputs, false, numberOfThreads);
+  pipeline.inverseOutputs(inputs, dPredictions, false, numberOfThreads);
+
+  auto numberOfInputs = options.NumberOfInputVariables;
+  auto numberOfOutputs = options.NumberOfOutputVariables;
+  for (int64_t row = 0; row < inputs.size(0); ++row) {
+    auto x = inputs.data_ptr<TensorDataType>() + row * numberOfInputs;
+    auto dX = dInputs.data_ptr<TensorDataType>() + row * numberOfInputs;
+    auto y = outputs.data_ptr<TensorDataType>() + row * numberOfOutputs;
+    auto dY = dOutputs.data_ptr<TensorDataType>() + row * numberOfOutputs;
+    auto prediction = predictions.data_ptr<TensorDataType>() + row * numberOfOutputs;
+    auto dPrediction = dPredictions.data_ptr<TensorDataType>() + row * numberOfOutputs;
+
+    double loss = 0.0;
+    for (uint32_t i = 0; i < numberOfOutputs; ++i) {
+      loss += std::pow(prediction[i] - y[i], 2.0);
+    }
+    loss /= numberOfOutputs;
 
     std::cout << "\nx: ";
-    for (uint32_t i = 0; i < options.NumberOfInputVariables; ++i) std::cout << inputTensor[i].item<TensorDataType>() << " (" << dInputTensor[i].item<TensorDataType>() << ") ";
+    for (uint32_t i = 0; i < numberOfInputs; ++i) std::cout << x[i] << " (" << dX[i] << ") ";
     std::cout << "\ny: ";
-    for (uint32_t i = 0; i < options.NumberOfOutputVariables; ++i) std::cout << outputTensor[i].item<TensorDataType>() << " (" << dOutputTensor[i].item<TensorDataType>() << ") ";
+    for (uint32_t i = 0; i < numberOfOutputs; ++i) std::cout << y[i] << " (" << dY[i] << ") ";
     std::cout << "\nprediction: ";
-    for (uint32_t i = 0; i < options.NumberOfOutputVariables; ++i) std::cout << prediction[i].item<TensorDataType>() << " (" << dPrediction[i].item<TensorDataType>() << ") ";
-    std::cout << "\nloss: " << loss.item<double>() << std::endl;
+    for (uint32_t i = 0; i < numberOfOutputs; ++i) std::cout << prediction[i] << " (" << dPrediction[i] << ") ";
+    std::cout << "\nloss: " << loss << std::endl;
   }
 }
 
-void Logic::saveValuesToFile(DataVector const& data, std::string const& path)
+void Logic::saveValuesToFile(Dataset const& data, std::string const& path, bool append)
 {
-  DataVector values(data.size());
-
-  size_t i = 0;
-  for (auto const& [inputTensor, outputTensor] : data) {
-    (void) outputTensor;
-    auto prediction = network->forward(inputTensor);
-    torch::Tensor dInputTensor = inputTensor.clone();
-
-    denormalizeInputTensor(dInputTensor, false);
-    denormalizeOutputTensor(inputTensor, prediction, false);
-
-    unscaleOutputTensor(inputTensor, prediction);
-
-    values[i++] = std::make_pair(dInputTensor, prediction);
+  if (data.empty()) {
+    return;
   }
-
-  Utilities::FileParser::SaveData(values, path, inputFileHeader);
+  // The predictions are inferred in batches and the whole part is denormalized at once:
+  auto numberOfThreads = static_cast<uint32_t>(options.NumberOfThreads);
+  auto inputs = data.inputs().to(TORCH_DATA_TYPE);
+  auto predictions = analyzer->predict(data);
+  pipeline.inverseOutputs(inputs, predictions, false, numberOfThreads);
+  auto dInputs = inputs.clone();
+  pipeline.denormalizeInputs(dInputs, false, numberOfThreads);
+
+  Utilities::FileParser::SaveData(Dataset(dInputs, predictions), path, inputFileHeader, append);
 }
 
-void Logic::saveDiffToFile(DataVector const& data, std::string const& path, bool outputRelativeDiff)
+void Logic::saveDiffToFile(Dataset const& data, std::string const& path, bool outputRelativeDiff, bool append)
 {
-  DataVector diff(data.size());
-
-  size_t i = 0;
-  for (auto const& [inputTensor, outputTensor] : data) {
-    auto prediction = network->forward(inputTensor);
-    torch::Tensor dInputTensor = inputTensor.clone();
-    torch::Tensor dOutputTensor = outputTensor.clone();
-
-    denormalizeInputTensor(dInputTensor, false);
-    denormalizeOutputTensor(inputTensor, dOutputTensor, false);
-    denormalizeOutputTensor(inputTensor, prediction, false);
-
-    unscaleOutputTensor(inputTensor, dOutputTensor);
-    unscaleOutputTensor(inputTensor, prediction);
-
-    torch::Tensor difference;
-    if (outputRelativeDiff) {
-      difference = NetworkAnalyzer::calculateRelativeDiff(dOutputTensor, prediction);
-    } else {
-      difference = NetworkAnalyzer::calculateDiff(dOutputTensor, prediction);
-    }
-
-    diff[i++] = std::make_pair(dInputTensor, difference);
+  if (data.empty()) {
+    return;
+  }
+  // The predictions are inferred in batches and the whole part is denormalized at once:
+  auto numberOfThreads = static_cast<uint32_t>(options.NumberOfThreads);
+  auto inputs = data.inputs().to(TORCH_DATA_TYPE);
+  auto dOutputs = data.outputs().to(TORCH_DATA_TYPE, false, true);
+  auto predictions = analyzer->predict(data);
+  pipeline.inverseOutputs(inputs, dOutputs, false, numberOfThreads);
+  pipeline.inverseOutputs(inputs, predictions, false, numberOfThreads);
+  auto dInputs = inputs.clone();
+  pipeline.denormalizeInputs(dInputs, false, numberOfThreads);
+
+  torch::Tensor differences;
+  if (outputRelativeDiff) {
+    differences = NetworkAnalyzer::calculateRelativeDiff(dOutputs, predictions);
+  } else {
+    differences = NetworkAnalyzer::calculateDiff(dOutputs, predictions);
   }
 
-  Utilities::FileParser::SaveData(diff, path, inputFileHeader);
+  Utilities::FileParser::SaveData(Dataset(dInputs, differences), path, inputFileHeader, append);
 }
 
 void Logic::saveMinMaxToFile() const
 {
-  auto inTensorDefault = torch::zeros(options.NumberOfInputVariables, TORCH_DATA_TYPE);
-  auto outTensorDefault = torch::zeros(options.NumberOfOutputVariables, TORCH_DATA_TYPE);
-
-  DataVector data = (useMixedScaling) ? DataVector(4) : DataVector(2);
-  data[0] = std::make_pair(inTensorDefault, outTensorDefault);
-  data[1] = std::make_pair(inTensorDefault.clone(), outTensorDefault.clone());
-  if (useMixedScaling) {
-    data[2] = std::make_pair(inTensorDefault.clone(), outTensorDefault.clone());
-    data[3] = std::make_pair(inTensorDefault.clone(), outTensorDefault.clone());
-  }
+  int64_t numberOfRows = useMixedScaling ? 4 : 2;
+  Dataset data(torch::zeros({numberOfRows, options.NumberOfInputVariables}, TORCH_DATA_TYPE),
+               torch::zeros({numberOfRows, options.NumberOfOutputVariables}, TORCH_DATA_TYPE));
 
   for (uint32_t i = 0; i < options.NumberOfInputVariables; ++i) {
     if (useMixedScaling) {
-      data[0].first[i] = mixedScalingMinMax.first.first[i].first;
-      data[1].first[i] = mixedScalingMinMax.first.first[i].second;
-      data[2].first[i] = mixedScalingMinMax.second.first[i].first;
-      data[3].first[i] = mixedScalingMinMax.second.first[i].second;
+      data.input(0)[i] = mixedScalingMinMax.first.first[i].first;
+      data.input(1)[i] = mixedScalingMinMax.first.first[i].second;
+      data.input(2)[i] = mixedScalingMinMax.second.first[i].first;
+      data.input(3)[i] = mixedScalingMinMax.second.first[i].second;
     } else {
-      data[0].first[i] = inputMinMax[i].first;
-      data[1].first[i] = inputMinMax[i].second;
+      data.input(0)[i] = inputMinMax[i].first;
+      data.input(1)[i] = inputMinMax[i].second;
     }
   }
 
   for (uint32_t i = 0; i < options.NumberOfOutputVariables; ++i) {
     if (useMixedScaling) {
-      data[0].second[i] = mixedScalingMinMax.first.second[i].first;
-      data[1].second[i] = mixedScalingMinMax.first.second[i].second;
-      data[2].second[i] = mixedScalingMinMax.second.second[i].first;
-      data[3].second[i] = mixedScalingMinMax.second.second[i].second;
+      data.output(0)[i] = mixedScalingMinMax.first.second[i].first;
+      data.output(1)[i] = mixedScalingMinMax.first.second[i].second;
+      data.output(2)[i] = mixedScalingMinMax.second.second[i].first;
+      data.output(3)[i] = mixedScalingMinMax.second.second[i].second;
     } else {
-      data[0].second[i] = outputMinMax[i].first;
-      data[1].second[i] = outputMinMax[i].second;
+      data.output(0)[i] = outputMinMax[i].first;
+      data.output(1)[i] = outputMinMax[i].second;
     }
   }
 
   Utilities::FileParser::SaveData(data, options.OutputMinMaxFilePath, inputFileHeader);
 }
 
-inline void Logic::denormalizeInputTensor(torch::Tensor& tensor, bool limitValues)
-{
-  Utilities::DataProcessor::Denormalize(tensor, (useMixedScaling) ? mixedScalingMinMax.first.first : inputMinMax, 0.0, 1.0, limitValues);
-}
-
-inline void Logic::denormalizeOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor, bool limitValues)
-{
-  if (useMixedScaling) {
-    if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= normalizedMixedScalingThreshold) {
-      Utilities::DataProcessor::Denormalize(outputTensor, mixedScalingMinMax.first.second, -1.0, 0.0, limitValues);
-    } else {
-      Utilities::DataProcessor::Denormalize(outputTensor, mixedScalingMinMax.second.second, 0.0, 1.0, limitValues);
-    }
-  } else {
-    Utilities::DataProcessor::Denormalize(outputTensor, outputMinMax, 0.0, 1.0, limitValues);
-  }
-}
-
-void Logic::unscaleOutputTensor(torch::Tensor const& inputTensor, torch::Tensor& outputTensor) const
-{
-  if (options.LogScaling) {
-    Utilities::DataProcessor::UnscaleLogarithmic(outputTensor);
-  }
-  else if (options.SqrtScaling) {
-    Utilities::DataProcessor::UnscaleSquareRoot(outputTensor);
-  }
-  else if (options.LogLinScaling) {
-    if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= normalizedMixedScalingThreshold) {
-      Utilities::DataProcessor::UnscaleLogarithmic(outputTensor);
-    }
-  }
-  else if (options.LogSqrtScaling) {
-    if (inputTensor[options.MixedScalingInputVariable].item<TensorDataType>() <= normalizedMixedScalingThreshold) {
-      Utilities::DataProcessor::UnscaleLogarithmic(outputTensor);
-    } else {
-      Utilities::DataProcessor::UnscaleSquareRoot(outputTensor);
-    }
-  }
-}
-
 bool Logic::minMaxValuesAreValid() const
 {
   auto validationFunction = [] (std::vector<std::pair<TensorDataType, TensorDataType>> const& data) {
@@ -1,122 +1,316 @@
 #include "NeuralNetwork/networkanalyzer.h"
 
+#include <numeric>
+
 namespace NeuralNetwork {
-  NetworkAnalyzer::NetworkAnalyzer(Network& network_, DenormalizeOutputTensorFunction denormFunction, UnscaleOutputTensorFunction unscaleFunction) :
-    network(network_), denormalizeOutputTensor(std::move(denormFunction)), unscaleOutputTensor(std::move(unscaleFunction))
+
+  namespace {
+
+  const size_t ROWS_PER_EVALUATION_BATCH = 1 << 14;
+
+  /*
+   * Calls the given function with a pointer to the values of the given tensor. Returns false (without calling the function), if the tensor is not
+   * contiguous or its data type is neither float nor double.
+   */
+  template<class Function>
+  bool withValuePointer(torch::Tensor const& tensor, Function const& function)
+  {
+    if (!tensor.is_contiguous()) {
+      return false;
+    }
+    switch (tensor.scalar_type()) {
+      case torch::kFloat:
+        function(tensor.data_ptr<float>());
+        return true;
+      case torch::kDouble:
+        function(tensor.data_ptr<double>());
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /*
+   * Returns the values of the given tensor as vector of doubles.
+   */
+  std::vector<double> toVector(torch::Tensor const& values)
   {
+    auto doubleValues = values.to(torch::kDouble).contiguous();
+    auto valuePointer = doubleValues.data_ptr<double>();
+    return std::vector<double>(valuePointer, valuePointer + doubleValues.numel());
+  }
+
   }
 
-  double NetworkAnalyzer::calculateMeanSquaredError(DataVector const& testData)
+  void ErrorAccumulator::add(torch::Tensor const& predictions, torch::Tensor const& outputs)
   {
-    double error = 0;
-    for (auto const& [x, y] : testData) {
-      auto prediction = network->forward(x);
-      auto loss = torch::mse_loss(prediction, y);
-      error += loss.item<double>();
+    auto numberOfColumns = static_cast<size_t>(outputs.size(-1));
+    if (squaredErrors.empty()) {
+      squaredErrors.assign(numberOfColumns, 0.0);
+    }
+
+    // A single row (e.g. of the row by row training) is added directly from the values, which avoids several tensor operations per row:
+    if (predictions.dim() == 1 || predictions.size(0) == 1) {
+      bool added = false;
+      withValuePointer(predictions, [&](auto predictionValues) {
+        added = withValuePointer(outputs, [&](auto outputValues) {
+          for (size_t i = 0; i < numberOfColumns; ++i) {
+            auto error = static_cast<double>(predictionValues[i]) - static_cast<double>(outputValues[i]);
+            squaredErrors[i] += error * error;
+          }
+        });
+      });
+      if (added) {
+        ++numberOfRows;
+        return;
+      }
     }
-    return error / testData.size();
+
+    torch::NoGradGuard noGrad;
+    auto errors = (predictions.detach().to(torch::kDouble) - outputs.to(torch::kDouble)).pow(2);
+    if (errors.dim() == 1) {
+      errors = errors.unsqueeze(0);
+    }
+
+    auto columnErrors = errors.sum(0).contiguous();
+    auto errorPointer = columnErrors.data_ptr<double>();
+    for (size_t i = 0; i < numberOfColumns; ++i) {
+      squaredErrors[i] += errorPointer[i];
+    }
+    numberOfRows += static_cast<size_t>(errors.size(0));
   }
 
-  std::vector<double> NetworkAnalyzer::calculateR2Score(DataVector const& testData)
+  void ErrorAccumulator::add(ErrorAccumulator const& other)
   {
-    if (testData.empty()) {
-      return std::vector<double>();
+    if (other.empty()) {
+      return;
     }
 
+    if (squaredErrors.empty()) {
+      squaredErrors.assign(other.squaredErrors.size(), 0.0);
+    }
+    for (size_t i = 0; i < squaredErrors.size(); ++i) {
+      squaredErrors[i] += other.squaredErrors[i];
+    }
+    numberOfRows += other.numberOfRows;
+  }
+
+  void ErrorAccumulator::reset()
+  {
+    squaredErrors.clear();
+    numberOfRows = 0;
+  }
+
+  bool ErrorAccumulator::empty() const
+  {
+    return numberOfRows == 0;
+  }
+
+  size_t ErrorAccumulator::getNumberOfRows() const
+  {
+    return numberOfRows;
+  }
+
+  double ErrorAccumulator::getMeanSquaredError() const
+  {
+    if (empty()) {
+      return 0.0;
+    }
+    auto sum = std::accumulate(squaredErrors.begin(), squaredErrors.end(), 0.0);
+    return sum / (static_cast<double>(numberOfRows) * squaredErrors.size());
+  }
+
+  std::vector<double> ErrorAccumulator::getR2Score(std::vector<double> const& outputVariances) const
+  {
     std::vector<double> scores{};
+    if (empty()) {
+      return scores;
+    }
 
-    for (int64_t i = 0; i < testData[0].second.size(0); ++i) {
-      double SQE = 0.0;
-      double SQT = 0.0;
+    for (size_t i = 0; i < outputVariances.size(); ++i) {
+      scores.push_back(1.0 - (squaredErrors[i] / numberOfRows) / outputVariances[i]);
+    }
+    return scores;
+  }
 
-      TensorDataType y_cross = 0.0;
-      for (auto const& [x, y] : testData) {
-        (void) x;
-        y_cross += y[i].item<TensorDataType>();
-      }
-      y_cross /= testData.size();
+  void ErrorAccumulator::write(torch::serialize::OutputArchive& archive) const
+  {
+    archive.write("numberOfRows", torch::tensor(std::vector<int64_t>{static_cast<int64_t>(numberOfRows)}, torch::kInt64));
+    if (!empty()) {
+      archive.write("squaredErrors", torch::tensor(squaredErrors, torch::kDouble));
+    }
+  }
+
+  void ErrorAccumulator::read(torch::serialize::InputArchive& archive)
+  {
+    torch::Tensor storedNumberOfRows;
+    archive.read("numberOfRows", storedNumberOfRows);
+    if (storedNumberOfRows.numel() != 1 || storedNumberOfRows.item<int64_t>() < 0) {
+      throw std::runtime_error("invalid number of rows of the accumulated errors");
+    }
+
+    reset();
+    if (storedNumberOfRows.item<int64_t>() > 0) {
+      torch::Tensor storedErrors;
+      archive.read("squaredErrors", storedErrors);
+      auto errors = storedErrors.to(torch::kDouble).contiguous();
+      auto errorPointer = errors.data_ptr<double>();
+      squaredErrors.assign(errorPointer, errorPointer + errors.numel());
+      numberOfRows = static_cast<size_t>(storedNumberOfRows.item<int64_t>());
+    }
+  }
+
+  NetworkAnalyzer::NetworkAnalyzer(Network& network_, Utilities::TransformPipeline const& pipeline_) :
+    network(network_), pipeline(pipeline_)
+  {
+  }
+
+  double NetworkAnalyzer::calculateMeanSquaredError(Dataset const& testData)
+  {
+    return calculateMeanSquaredError([&testData](DataPartFunction const& function) { function(testData); });
+  }
+
+  double NetworkAnalyzer::calculateMeanSquaredError(DataPartIterator const& forEachPart)
+  {
+    ErrorAccumulator errors{};
+    accumulateErrors(forEachPart, errors);
+    return errors.getMeanSquaredError();
+  }
 
-      for (auto const& [x, y] : testData) {
-        auto prediction = network->forward(x);
+  torch::Tensor NetworkAnalyzer::predict(Dataset const& data)
+  {
+    torch::NoGradGuard noGrad;
+    auto predictions = torch::empty({static_cast<int64_t>(data.size()), data.getNumberOfOutputVariables()}, TORCH_DATA_TYPE);
+    for (size_t begin = 0; begin < data.size(); begin += ROWS_PER_EVALUATION_BATCH) {
+      auto end = std::min(begin + ROWS_PER_EVALUATION_BATCH, data.size());
+      auto batch = data.slice(begin, end);
+      predictions.narrow(0, static_cast<int64_t>(begin), static_cast<int64_t>(end - begin)).copy_(network->forward(batch.inputs()));
+    }
+    return predictions;
+  }
 
-        SQE += std::pow(prediction[i].item<TensorDataType>() - y_cross, 2.0);
-        SQT += std::pow(y[i].item<TensorDataType>() - y_cross, 2.0);
+  void NetworkAnalyzer::accumulateErrors(DataPartIterator const& forEachPart, ErrorAccumulator& errors)
+  {
+    torch::NoGradGuard noGrad;
+    forEachPart([this, &errors](Dataset const& part) {
+      for (size_t begin = 0; begin < part.size(); begin += ROWS_PER_EVALUATION_BATCH) {
+        auto batch = part.slice(begin, std::min(begin + ROWS_PER_EVALUATION_BATCH, part.size()));
+        errors.add(network->forward(batch.inputs()), batch.outputs());
       }
+    });
+  }
+
+  std::vector<double> NetworkAnalyzer::calculateOutputVariances(DataPartIterator const& forEachPart)
+  {
+    // Mean and sum of squared deviations from the mean (M2) of each column, the parts are merged pairwise (Chan et al.):
+    torch::Tensor mean{};
+    torch::Tensor M2{};
+    size_t numberOfRows = 0;
+
+    forEachPart([&](Dataset const& part) {
+      if (part.empty()) {
+        return;
+      }
+      auto outputs = part.outputs().to(torch::kDouble);
+      auto partMean = outputs.mean(0);
+      auto partM2 = (outputs - partMean).pow(2).sum(0);
+
+      if (numberOfRows == 0) {
+        mean = partMean;
+        M2 = partM2;
+        numberOfRows = part.size();
+        return;
+      }
+
+      auto combinedNumberOfRows = numberOfRows + part.size();
+      auto delta = partMean - mean;
+      M2 = M2 + partM2 + delta.pow(2) * (static_cast<double>(numberOfRows) * part.size() / combinedNumberOfRows);
+      mean = mean + delta * (static_cast<double>(part.size()) / combinedNumberOfRows);
+      numberOfRows = combinedNumberOfRows;
+    });
 
-      scores.push_back(SQE / SQT);
+    if (numberOfRows == 0) {
+      return std::vector<double>();
     }
 
-    return scores;
+    return toVector(M2 / static_cast<double>(numberOfRows));
   }
 
-  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternate(DataVector const& testData)
+  std::vector<double> NetworkAnalyzer::calculateR2Score(Dataset const& testData)
   {
     if (testData.empty()) {
       return std::vector<double>();
     }
 
-    std::vector<double> scores{};
+    // All columns are calculated at once:
+    auto outputs = testData.outputs().to(torch::kDouble);
+    auto predictions = predict(testData).to(torch::kDouble);
+    auto y_cross = outputs.mean(0);
 
-    for (int64_t i = 0; i < testData[0].second.size(0); ++i) {
-      double SQR = 0.0;
-      double SQT = 0.0;
+    auto SQE = (predictions - y_cross).pow(2).sum(0);
+    auto SQT = (outputs - y_cross).pow(2).sum(0);
 
-      TensorDataType y_cross = 0.0;
-      for (auto const& [x, y] : testData) {
-        (void) x;
-        y_cross += y[i].item<TensorDataType>();
-      }
-      y_cross /= testData.size();
+    return toVector(SQE / SQT);
+  }
 
-      for (auto const& [x, y] : testData) {
-        auto prediction = network->forward(x);
-        TensorDataType yi = y[i].item<TensorDataType>();
+  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternate(Dataset const& testData)
+  {
+    if (testData.empty()) {
+      return std::vector<double>();
+    }
 
-        SQR += std::pow(yi - prediction[i].item<TensorDataType>(), 2.0);
-        SQT += std::pow(yi - y_cross, 2.0);
-      }
+    // All columns are calculated at once:
+    auto outputs = testData.outputs().to(torch::kDouble);
+    auto predictions = predict(testData).to(torch::kDouble);
+    auto y_cross = outputs.mean(0);
 
-      scores.push_back(1.0 - (SQR / SQT));
-    }
+    auto SQR = (outputs - predictions).pow(2).sum(0);
+    auto SQT = (outputs - y_cross).pow(2).sum(0);
 
-    return scores;
+    return toVector(1.0 - SQR / SQT);
+  }
+
+  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternate(DataPartIterator const& forEachPart)
+  {
+    // The squared residuals are accumulated with batched inference, the variances of the outputs are merged pairwise in a second pass:
+    ErrorAccumulator errors{};
+    accumulateErrors(forEachPart, errors);
+    return errors.getR2Score(calculateOutputVariances(forEachPart));
   }
 
-  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternateDenormalized(DataVector const& testData)
+  std::vector<double> NetworkAnalyzer::calculateR2ScoreAlternateDenormalized(Dataset const& testData)
   {
     if (testData.empty()) {
       return std::vector<double>();
     }
 
+    // The values are denormalized once for all columns:
+    auto inputs = testData.inputs().to(TORCH_DATA_TYPE);
+    auto outputs = testData.outputs().to(TORCH_DATA_TYPE, false, true).contiguous();
+    auto predictions = predict(testData);
+    pipeline.inverseOutputs(inputs, outputs);
+    pipeline.inverseOutputs(inputs, predictions);
+    auto yD = outputs.data_ptr<TensorDataType>();
+    auto predictionD = predictions.data_ptr<TensorDataType>();
+    auto numberOfRows = outputs.size(0);
+    auto numberOfColumns = outputs.size(1);
+
     std::vector<double> scores{};
 
-    for (int64_t i = 0; i < testData[0].second.size(0); ++i) {
+    for (int64_t i = 0; i < numberOfColumns; ++i) {
       double SQR = 0.0;
       double SQT = 0.0;
 
       TensorDataType y_cross = 0.0;
-      for (auto const& [x, y] : testData) {
-        auto yD = y.clone();
-        denormalizeOutputTensor(x, yD, false);
-
-        unscaleOutputTensor(x, yD);
-
-        y_cross += yD[i].item<TensorDataType>();
+      for (int64_t row = 0; row < numberOfRows; ++row) {
+        y_cross += yD[row * numberOfColumns + i];
       }
       y_cross /= testData.size();
 
-      for (auto const& [x, y] : testData) {
-        auto prediction = network->forward(x);
-        auto yD = y.clone();
-        denormalizeOutputTensor(x, yD, false);
-        denormalizeOutputTensor(x, prediction, false);
-
-        unscaleOutputTensor(x, yD);
-        unscaleOutputTensor(x, prediction);
-
-        TensorDataType yi = yD[i].item<TensorDataType>();
+      for (int64_t row = 0; row < numberOfRows; ++row) {
+        TensorDataType yi = yD[row * numberOfColumns + i];
 
-        SQR += std::pow(yi - prediction[i].item<TensorDataType>(), 2.0);
+        SQR += std::pow(yi - predictionD[row * numberOfColumns + i], 2.0);
         SQT += std::pow(yi - y_cross, 2.0);
       }
 
@@ -128,23 +322,11 @@ namespace NeuralNetwork {
 
   torch::Tensor NetworkAnalyzer::calculateDiff(torch::Tensor const& wantedValue, torch::Tensor const& actualValue)
   {
-    auto output = wantedValue.clone();
-
-    for (int64_t i = 0; i < wantedValue.size(0); ++i) {
-      output[i] -= actualValue[i].item<TensorDataType>();
-    }
-
-    return output;
+    return wantedValue - actualValue;
   }
 
   torch::Tensor NetworkAnalyzer::calculateRelativeDiff(torch::Tensor const& wantedValue, torch::Tensor const& actualValue)
   {
-    auto diff = calculateDiff(wantedValue, actualValue);
-
-    for (int64_t i = 0; i < wantedValue.size(0); ++i) {
-      diff[i] /= wantedValue[i].item<TensorDataType>();
-    }
-
-    return diff;
+    return calculateDiff(wantedValue, actualValue) / wantedValue;
   }
 }
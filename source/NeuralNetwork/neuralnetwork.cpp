@@ -3,7 +3,9 @@
 
 namespace NeuralNetwork {
 
-NetworkImpl::NetworkImpl(uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNode, std::vector<uint32_t> const& hiddenLayers)
+NetworkImpl::NetworkImpl(uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNode, std::vector<uint32_t> const& hiddenLayers,
+                         torch::ScalarType const dataType_) :
+  dataType(dataType_)
 {
   if (hiddenLayers.empty()) {
     addLayer(0, numberOfInputNodes, numberOfOutputNode);
@@ -20,6 +22,7 @@ NetworkImpl::NetworkImpl(uint32_t const numberOfInputNodes, uint32_t const numbe
 
 torch::Tensor NetworkImpl::forward(torch::Tensor x)
 {
+  x = x.to(dataType);
   for (auto& layer : layers) {
     x = layer->forward(x);
   }
@@ -31,7 +34,7 @@ void NetworkImpl::addLayer(size_t const layerNumber, uint32_t const numberOfInpu
 {
   layers.emplace_back(register_module("layer" + std::to_string(layerNumber),
     torch::nn::Sequential(torch::nn::Linear(numberOfInputNodes, numberOfOutputNodes), torch::nn::Functional(torch::leaky_relu, 0.2))));
-  layers[layerNumber]->to(TORCH_DATA_TYPE);
+  layers[layerNumber]->to(dataType);
 }
 
 }
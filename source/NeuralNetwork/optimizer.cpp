@@ -0,0 +1,167 @@
+#include "NeuralNetwork/optimizer.h"
+
+#include <cmath>
+
+namespace NeuralNetwork {
+
+namespace {
+
+const double MINIMUM_LEARN_RATE_FACTOR = 1e-4; // final learning rate of the cosine and one-cycle schedule relative to the set learning rate
+const double ONE_CYCLE_WARM_UP_PERCENTAGE = 0.3;
+const double ONE_CYCLE_INITIAL_FACTOR = 1.0 / 25.0;
+
+/*
+ * Returns the learning rate, which is annealed from the start to the end value with a cosine for progress in [0, 1].
+ */
+double annealWithCosine(double const start, double const end, double const progress)
+{
+  return end + (start - end) * 0.5 * (1.0 + std::cos(M_PI * progress));
+}
+
+}
+
+Optimizer::Optimizer(std::vector<torch::Tensor> const& parameters_, Utilities::ProgramOptions const& options_) :
+  options(options_), parameters(parameters_), learnRate(options_.LearnRate)
+{
+  using Utilities::OptimizerType;
+
+  switch (options.Optimizer) {
+    case OptimizerType::SGD:
+      optimizer = std::make_unique<torch::optim::SGD>(parameters, torch::optim::SGDOptions(learnRate)
+        .momentum(options.Momentum).nesterov(options.Nesterov).weight_decay(options.WeightDecay));
+      break;
+    case OptimizerType::Adam:
+      optimizer = std::make_unique<torch::optim::Adam>(parameters, torch::optim::AdamOptions(learnRate).weight_decay(options.WeightDecay));
+      break;
+    case OptimizerType::AdamW:
+      // The weight decay is decoupled from the gradient and applied in step():
+      optimizer = std::make_unique<torch::optim::Adam>(parameters, torch::optim::AdamOptions(learnRate));
+      break;
+    case OptimizerType::RMSprop:
+      optimizer = std::make_unique<torch::optim::RMSprop>(parameters, torch::optim::RMSpropOptions(learnRate)
+        .momentum(options.Momentum).weight_decay(options.WeightDecay));
+      break;
+    case OptimizerType::LBFGS:
+      optimizer = std::make_unique<torch::optim::LBFGS>(parameters, torch::optim::LBFGSOptions(learnRate).line_search_fn("strong_wolfe"));
+      break;
+    case OptimizerType::LevenbergMarquardt:
+      break;
+  }
+}
+
+void Optimizer::zeroGrad()
+{
+  if (!optimizer) {
+    return;
+  }
+
+  optimizer->zero_grad();
+}
+
+void Optimizer::step(std::function<torch::Tensor()> const& closure)
+{
+  if (!optimizer) {
+    return;
+  }
+
+  if (options.Optimizer == Utilities::OptimizerType::AdamW && options.WeightDecay > 0.0) {
+    torch::NoGradGuard noGrad;
+    for (auto& parameter : parameters) {
+      parameter.mul_(1.0 - learnRate * options.WeightDecay);
+    }
+  }
+
+  optimizer->step(closure);
+}
+
+void Optimizer::startEpoch(uint32_t const epoch, uint32_t const numberOfDeteriorationsInRow)
+{
+  using Utilities::LearnRateScheduleType;
+
+  // The cosine and one-cycle schedule end after the set number of epochs, further epochs use the final learning rate:
+  auto progress = std::min(static_cast<double>(epoch - 1) / std::max(options.NumberOfEpochs, 1u), 1.0);
+
+  switch (options.LearnRateSchedule) {
+    case LearnRateScheduleType::Constant:
+      return;
+    case LearnRateScheduleType::Step:
+      setLearnRate(options.LearnRate * std::pow(options.LearnRateFactor, (epoch - 1) / options.LearnRateStepEpochs));
+      return;
+    case LearnRateScheduleType::Cosine:
+      setLearnRate(annealWithCosine(options.LearnRate, options.LearnRate * MINIMUM_LEARN_RATE_FACTOR, progress));
+      return;
+    case LearnRateScheduleType::OneCycle:
+      if (progress < ONE_CYCLE_WARM_UP_PERCENTAGE) {
+        auto initialLearnRate = options.LearnRate * ONE_CYCLE_INITIAL_FACTOR;
+        setLearnRate(initialLearnRate + (options.LearnRate - initialLearnRate) * progress / ONE_CYCLE_WARM_UP_PERCENTAGE);
+      } else {
+        setLearnRate(annealWithCosine(options.LearnRate, options.LearnRate * MINIMUM_LEARN_RATE_FACTOR,
+                                      (progress - ONE_CYCLE_WARM_UP_PERCENTAGE) / (1.0 - ONE_CYCLE_WARM_UP_PERCENTAGE)));
+      }
+      return;
+    case LearnRateScheduleType::ReduceOnPlateau:
+      // The first epoch has no previous error to compare with. Afterwards, the learning rate is reduced each time the set number of
+      // deteriorations (see --numberOfDeteriorations) is exceeded:
+      if (epoch > 1 && numberOfDeteriorationsInRow > 0 && numberOfDeteriorationsInRow % (options.NumberOfDeteriorations + 1) == 0) {
+        setLearnRate(learnRate * options.LearnRateFactor);
+      }
+      return;
+  }
+}
+
+void Optimizer::write(torch::serialize::OutputArchive& archive) const
+{
+  archive.write("learnRate", torch::tensor(std::vector<double>{learnRate}, torch::kDouble));
+  if (optimizer) {
+    torch::serialize::OutputArchive optimizerArchive{};
+    optimizer->save(optimizerArchive);
+    archive.write("optimizer", optimizerArchive);
+  }
+}
+
+void Optimizer::read(torch::serialize::InputArchive& archive)
+{
+  torch::Tensor storedLearnRate;
+  archive.read("learnRate", storedLearnRate);
+  if (storedLearnRate.numel() != 1) {
+    throw std::runtime_error("invalid learning rate of the optimizer");
+  }
+  if (optimizer) {
+    torch::serialize::InputArchive optimizerArchive{};
+    archive.read("optimizer", optimizerArchive);
+    optimizer->load(optimizerArchive);
+  }
+  setLearnRate(storedLearnRate.item<double>());
+}
+
+void Optimizer::setLearnRate(double const learnRate_)
+{
+  using Utilities::OptimizerType;
+
+  learnRate = learnRate_;
+  if (!optimizer) {
+    return;
+  }
+
+  for (auto& group : optimizer->param_groups()) {
+    switch (options.Optimizer) {
+      case OptimizerType::SGD:
+        static_cast<torch::optim::SGDOptions&>(group.options()).lr(learnRate);
+        break;
+      case OptimizerType::Adam:
+      case OptimizerType::AdamW:
+        static_cast<torch::optim::AdamOptions&>(group.options()).lr(learnRate);
+        break;
+      case OptimizerType::RMSprop:
+        static_cast<torch::optim::RMSpropOptions&>(group.options()).lr(learnRate);
+        break;
+      case OptimizerType::LBFGS:
+        static_cast<torch::optim::LBFGSOptions&>(group.options()).lr(learnRate);
+        break;
+      case OptimizerType::LevenbergMarquardt:
+        break;
+    }
+  }
+}
+
+}
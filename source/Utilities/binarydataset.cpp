@@ -0,0 +1,364 @@
+#include "Utilities/binarydataset.h"
+#include "Utilities/mappedfile.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+namespace Utilities {
+
+namespace {
+
+const char FILE_IDENTIFIER[8] = {'N', 'N', 'A', 'B', 'I', 'N', '\0', '\0'};
+const uint32_t FORMAT_VERSION = 1;
+const uint32_t DATA_TYPE_FLOAT64 = 1;
+const uint64_t DATA_ALIGNMENT = 4096;  // the data block starts at a page boundary
+const uint64_t COLUMN_ALIGNMENT = 64;  // each column starts at a cache line boundary
+
+struct FileLayout
+{
+  char identifier[8];
+  uint32_t version;
+  uint32_t dataType;
+  uint64_t numberOfRows;
+  uint32_t numberOfInputColumns;
+  uint32_t numberOfOutputColumns;
+  uint64_t fileHeaderLength;
+  uint64_t dataOffset;
+  uint64_t columnStride; // distance between two columns in number of values
+};
+
+static_assert(std::is_trivially_copyable_v<FileLayout>);
+static_assert(std::is_same_v<TensorDataType, double>, "The binary dataset format stores 64 bit floating point values.");
+
+inline uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+  return ((value + alignment - 1) / alignment) * alignment;
+}
+
+inline uint64_t getMetaDataSize(FileLayout const& layout)
+{
+  auto numberOfColumns = static_cast<uint64_t>(layout.numberOfInputColumns) + layout.numberOfOutputColumns;
+  return sizeof(FileLayout) + layout.fileHeaderLength + numberOfColumns * 2 * sizeof(TensorDataType);
+}
+
+inline uint64_t getFileSize(FileLayout const& layout)
+{
+  auto numberOfColumns = static_cast<uint64_t>(layout.numberOfInputColumns) + layout.numberOfOutputColumns;
+  return layout.dataOffset + numberOfColumns * layout.columnStride * sizeof(TensorDataType);
+}
+
+/*
+ * Checks the layout of a binary dataset file with the given size. Errors are printed to the console.
+ */
+bool validateLayout(FileLayout const& layout, uint64_t fileSize, FilePath const& path, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables)
+{
+  if (std::memcmp(layout.identifier, FILE_IDENTIFIER, sizeof(FILE_IDENTIFIER)) != 0) {
+    std::cout << "Error: \"" << path << "\" is not a valid binary dataset file." << std::endl;
+    return false;
+  }
+  if (layout.version != FORMAT_VERSION || layout.dataType != DATA_TYPE_FLOAT64) {
+    std::cout << "Error: Unsupported binary dataset version " << layout.version << " (data type " << layout.dataType << "). Please convert the input file again." << std::endl;
+    return false;
+  }
+  if (layout.numberOfInputColumns != numberOfInputVariables || layout.numberOfOutputColumns != numberOfOutputVariables) {
+    std::cout << "Error: The binary dataset contains " << layout.numberOfInputColumns << " input and " << layout.numberOfOutputColumns
+              << " output variables, but " << numberOfInputVariables << " input and " << numberOfOutputVariables << " output variables are expected." << std::endl;
+    return false;
+  }
+  if (layout.columnStride < layout.numberOfRows || layout.dataOffset < getMetaDataSize(layout) || layout.dataOffset % sizeof(TensorDataType) != 0 ||
+      fileSize < getFileSize(layout)) {
+    std::cout << "Error: The binary dataset \"" << path << "\" is truncated or corrupt." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Reads the file header and the min/max values, which follow the fixed size file layout.
+ */
+void readMetaData(char const* position, FileLayout const& layout, std::string& fileHeader, MinMaxValues& minMax)
+{
+  position += sizeof(FileLayout);
+  fileHeader = std::string(position, layout.fileHeaderLength);
+  position += layout.fileHeaderLength;
+
+  minMax = std::make_pair(MinMaxVector(layout.numberOfInputColumns), MinMaxVector(layout.numberOfOutputColumns));
+  for (auto* minMaxVector : {&minMax.first, &minMax.second}) {
+    for (auto& [min, max] : *minMaxVector) {
+      std::memcpy(&min, position, sizeof(min));
+      std::memcpy(&max, position + sizeof(min), sizeof(max));
+      position += 2 * sizeof(TensorDataType);
+    }
+  }
+}
+
+bool writeAll(int fileDescriptor, void const* data, uint64_t size, uint64_t offset)
+{
+  auto position = static_cast<char const*>(data);
+  while (size > 0) {
+    auto written = ::pwrite(fileDescriptor, position, size, static_cast<off_t>(offset));
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    position += written;
+    offset += static_cast<uint64_t>(written);
+    size -= static_cast<uint64_t>(written);
+  }
+  return true;
+}
+
+bool readAll(int fileDescriptor, void* data, uint64_t size, uint64_t offset)
+{
+  auto position = static_cast<char*>(data);
+  while (size > 0) {
+    auto bytesRead = ::pread(fileDescriptor, position, size, static_cast<off_t>(offset));
+    if (bytesRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytesRead <= 0) {
+      return false;
+    }
+    position += bytesRead;
+    offset += static_cast<uint64_t>(bytesRead);
+    size -= static_cast<uint64_t>(bytesRead);
+  }
+  return true;
+}
+
+}
+
+bool BinaryDataset::IsBinaryDatasetFile(FilePath const& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  char identifier[sizeof(FILE_IDENTIFIER)] = {};
+  if (!file.read(identifier, sizeof(identifier))) {
+    return false;
+  }
+  return std::memcmp(identifier, FILE_IDENTIFIER, sizeof(FILE_IDENTIFIER)) == 0;
+}
+
+bool BinaryDataset::Save(FilePath const& path, Dataset const& data, std::string const& fileHeader, MinMaxValues const& minMax)
+{
+  BinaryDatasetWriter writer(path, fileHeader, data.size(), static_cast<uint32_t>(data.getNumberOfInputVariables()), static_cast<uint32_t>(data.getNumberOfOutputVariables()));
+
+  return writer.isOpen() && writer.writeRows(0, data) && writer.finish(minMax);
+}
+
+std::optional<Dataset> BinaryDataset::Load(FilePath const& path, uint32_t const numberOfInputVariables, uint32_t const numberOfOutputVariables,
+                                           std::string& fileHeader, MinMaxValues& minMax)
+{
+  auto file = std::make_shared<MappedFile>(path);
+  if (!file->isOpen() || file->size() < sizeof(FileLayout)) {
+    std::cout << "Error: \"" << path << "\" is not a valid binary dataset file." << std::endl;
+    return std::nullopt;
+  }
+
+  FileLayout layout{};
+  std::memcpy(&layout, file->data(), sizeof(layout));
+
+  if (!validateLayout(layout, file->size(), path, numberOfInputVariables, numberOfOutputVariables)) {
+    return std::nullopt;
+  }
+  readMetaData(file->data(), layout, fileHeader, minMax);
+
+  // The tensors keep the mapping alive. The mapping is read-only, so the tensors must not be changed:
+  auto deleter = [file](void*) {};
+  auto data = reinterpret_cast<TensorDataType*>(const_cast<char*>(file->data()) + layout.dataOffset);
+  auto numberOfRows = static_cast<int64_t>(layout.numberOfRows);
+  auto columnStride = static_cast<int64_t>(layout.columnStride);
+
+  auto inputs = torch::from_blob(data, {numberOfRows, numberOfInputVariables}, {1, columnStride}, deleter, TORCH_DATA_TYPE);
+  auto outputs = torch::from_blob(data + numberOfInputVariables * columnStride, {numberOfRows, numberOfOutputVariables}, {1, columnStride}, deleter, TORCH_DATA_TYPE);
+
+  return std::make_optional(Dataset(inputs, outputs));
+}
+
+BinaryDatasetWriter::BinaryDatasetWriter(FilePath const& path_, std::string const& fileHeader, uint64_t const numberOfRows_,
+                                         uint32_t const numberOfInputVariables, uint32_t const numberOfOutputVariables) :
+  path(path_), numberOfRows(numberOfRows_)
+{
+  FileLayout layout{};
+  std::memcpy(layout.identifier, FILE_IDENTIFIER, sizeof(FILE_IDENTIFIER));
+  layout.version = FORMAT_VERSION;
+  layout.dataType = DATA_TYPE_FLOAT64;
+  layout.numberOfRows = numberOfRows;
+  layout.numberOfInputColumns = numberOfInputVariables;
+  layout.numberOfOutputColumns = numberOfOutputVariables;
+  layout.fileHeaderLength = fileHeader.size();
+  layout.dataOffset = alignUp(getMetaDataSize(layout), DATA_ALIGNMENT);
+  layout.columnStride = alignUp(layout.numberOfRows * sizeof(TensorDataType), COLUMN_ALIGNMENT) / sizeof(TensorDataType);
+
+  columnStride = layout.columnStride;
+  dataOffset = layout.dataOffset;
+  minMaxOffset = sizeof(FileLayout) + layout.fileHeaderLength;
+
+  fileDescriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fileDescriptor < 0) {
+    std::cout << "Error: Unable to open \"" << path << "\" to save the binary dataset." << std::endl;
+    return;
+  }
+
+  // The file gets its final size first (the padding stays zero), so that the columns can be written chunk by chunk:
+  if (::ftruncate(fileDescriptor, static_cast<off_t>(getFileSize(layout))) != 0 ||
+      !writeAll(fileDescriptor, &layout, sizeof(layout), 0) ||
+      !writeAll(fileDescriptor, fileHeader.data(), fileHeader.size(), sizeof(layout))) {
+    std::cout << "Error: Unable to write the binary dataset to \"" << path << "\"." << std::endl;
+    ::close(fileDescriptor);
+    fileDescriptor = -1;
+  }
+}
+
+BinaryDatasetWriter::~BinaryDatasetWriter()
+{
+  if (fileDescriptor >= 0) {
+    ::close(fileDescriptor);
+  }
+}
+
+bool BinaryDatasetWriter::isOpen() const
+{
+  return fileDescriptor >= 0;
+}
+
+bool BinaryDatasetWriter::writeRows(uint64_t const firstRow, Dataset const& rows)
+{
+  auto inputs = rows.inputs();
+  auto outputs = rows.outputs();
+  auto numberOfRowsToWrite = static_cast<uint64_t>(rows.size());
+  if (fileDescriptor < 0 || firstRow + numberOfRowsToWrite > numberOfRows) {
+    return false;
+  }
+
+  uint64_t columnIndex = 0;
+  for (auto const* matrix : {&inputs, &outputs}) {
+    for (int64_t i = 0; i < matrix->size(1); ++i, ++columnIndex) {
+      auto column = matrix->select(1, i).contiguous();
+      auto offset = dataOffset + (columnIndex * columnStride + firstRow) * sizeof(TensorDataType);
+      if (!writeAll(fileDescriptor, column.data_ptr<TensorDataType>(), numberOfRowsToWrite * sizeof(TensorDataType), offset)) {
+        std::cout << "Error: Unable to write the binary dataset to \"" << path << "\"." << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool BinaryDatasetWriter::finish(MinMaxValues const& minMax)
+{
+  if (fileDescriptor < 0) {
+    return false;
+  }
+
+  std::vector<TensorDataType> minMaxData{};
+  for (auto const* minMaxVector : {&minMax.first, &minMax.second}) {
+    for (auto const& [min, max] : *minMaxVector) {
+      minMaxData.push_back(min);
+      minMaxData.push_back(max);
+    }
+  }
+
+  bool success = writeAll(fileDescriptor, minMaxData.data(), minMaxData.size() * sizeof(TensorDataType), minMaxOffset);
+  success = (::close(fileDescriptor) == 0) && success;
+  fileDescriptor = -1;
+
+  if (!success) {
+    std::cout << "Error: Unable to write the binary dataset to \"" << path << "\"." << std::endl;
+  }
+  return success;
+}
+
+BinaryDatasetReader::BinaryDatasetReader(FilePath const& path_, uint32_t const numberOfInputVariables_, uint32_t const numberOfOutputVariables_) :
+  path(path_), numberOfInputVariables(numberOfInputVariables_), numberOfOutputVariables(numberOfOutputVariables_)
+{
+  fileDescriptor = ::open(path.c_str(), O_RDONLY);
+  struct stat fileStatus{};
+  FileLayout layout{};
+  if (fileDescriptor < 0 || ::fstat(fileDescriptor, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode) ||
+      !readAll(fileDescriptor, &layout, sizeof(layout), 0)) {
+    std::cout << "Error: \"" << path << "\" is not a valid binary dataset file." << std::endl;
+    if (fileDescriptor >= 0) {
+      ::close(fileDescriptor);
+      fileDescriptor = -1;
+    }
+    return;
+  }
+
+  std::vector<char> metaData{};
+  bool valid = validateLayout(layout, static_cast<uint64_t>(fileStatus.st_size), path, numberOfInputVariables, numberOfOutputVariables);
+  if (valid) {
+    metaData.resize(getMetaDataSize(layout));
+    valid = readAll(fileDescriptor, metaData.data(), metaData.size(), 0);
+  }
+  if (!valid) {
+    ::close(fileDescriptor);
+    fileDescriptor = -1;
+    return;
+  }
+
+  readMetaData(metaData.data(), layout, fileHeader, minMax);
+  numberOfRows = layout.numberOfRows;
+  columnStride = layout.columnStride;
+  dataOffset = layout.dataOffset;
+  ::posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+BinaryDatasetReader::~BinaryDatasetReader()
+{
+  if (fileDescriptor >= 0) {
+    ::close(fileDescriptor);
+  }
+}
+
+bool BinaryDatasetReader::isOpen() const
+{
+  return fileDescriptor >= 0;
+}
+
+uint64_t BinaryDatasetReader::getNumberOfRows() const
+{
+  return numberOfRows;
+}
+
+std::string const& BinaryDatasetReader::getFileHeader() const
+{
+  return fileHeader;
+}
+
+MinMaxValues const& BinaryDatasetReader::getMinMax() const
+{
+  return minMax;
+}
+
+std::optional<Dataset> BinaryDatasetReader::readRows(uint64_t const firstRow, uint64_t const numberOfRowsToRead) const
+{
+  if (fileDescriptor < 0 || firstRow + numberOfRowsToRead > numberOfRows) {
+    return std::nullopt;
+  }
+
+  // The chunk is stored column by column like in the file, so each column is read with a single call:
+  auto numberOfColumns = static_cast<uint64_t>(numberOfInputVariables) + numberOfOutputVariables;
+  auto buffer = torch::empty({static_cast<int64_t>(numberOfColumns), static_cast<int64_t>(numberOfRowsToRead)}, TORCH_DATA_TYPE);
+  auto data = buffer.data_ptr<TensorDataType>();
+
+  for (uint64_t i = 0; i < numberOfColumns; ++i) {
+    auto offset = dataOffset + (i * columnStride + firstRow) * sizeof(TensorDataType);
+    if (!readAll(fileDescriptor, data + i * numberOfRowsToRead, numberOfRowsToRead * sizeof(TensorDataType), offset)) {
+      std::cout << "Error: Unable to read rows " << firstRow << " to " << firstRow + numberOfRowsToRead << " of \"" << path << "\"." << std::endl;
+      return std::nullopt;
+    }
+  }
+
+  return std::make_optional(Dataset(buffer.narrow(0, 0, numberOfInputVariables).t(), buffer.narrow(0, numberOfInputVariables, numberOfOutputVariables).t()));
+}
+
+}
@@ -0,0 +1,171 @@
+#include "Utilities/columnstatistics.h"
+
+#include <limits>
+
+namespace Utilities {
+
+namespace {
+
+const int64_t ROWS_PER_BLOCK = 1024; // the rows of a block are read twice (sum, squared differences), so a block should fit into the cache
+
+}
+
+ColumnStatistics::ColumnStatistics(size_t const numberOfColumns) :
+  minimum(numberOfColumns), maximum(numberOfColumns), mean(numberOfColumns), m2(numberOfColumns)
+{
+}
+
+void ColumnStatistics::addRows(TensorDataType const* values, int64_t const numberOfRows, uint8_t const* rowMask, uint8_t const selectedValue)
+{
+  auto numberOfColumns = getNumberOfColumns();
+  std::vector<TensorDataType> blockMinimum(numberOfColumns);
+  std::vector<TensorDataType> blockMaximum(numberOfColumns);
+  std::vector<TensorDataType> blockMean(numberOfColumns);
+  std::vector<TensorDataType> blockM2(numberOfColumns);
+
+  // Each block is added with two passes over its (cached) rows, which is numerically stable and keeps the inner loops free of divisions:
+  for (int64_t firstRow = 0; firstRow < numberOfRows; firstRow += ROWS_PER_BLOCK) {
+    auto lastRow = std::min(firstRow + ROWS_PER_BLOCK, numberOfRows);
+    std::fill(blockMinimum.begin(), blockMinimum.end(), std::numeric_limits<TensorDataType>::infinity());
+    std::fill(blockMaximum.begin(), blockMaximum.end(), -std::numeric_limits<TensorDataType>::infinity());
+    std::fill(blockMean.begin(), blockMean.end(), 0.0);
+    std::fill(blockM2.begin(), blockM2.end(), 0.0);
+
+    uint64_t blockCount = 0;
+    for (auto row = firstRow; row < lastRow; ++row) {
+      if (rowMask && rowMask[row] != selectedValue) {
+        continue;
+      }
+      ++blockCount;
+      auto rowValues = values + row * static_cast<int64_t>(numberOfColumns);
+      for (size_t i = 0; i < numberOfColumns; ++i) {
+        blockMinimum[i] = std::min(blockMinimum[i], rowValues[i]);
+        blockMaximum[i] = std::max(blockMaximum[i], rowValues[i]);
+        blockMean[i] += rowValues[i];
+      }
+    }
+    if (blockCount == 0) {
+      continue;
+    }
+
+    for (size_t i = 0; i < numberOfColumns; ++i) {
+      blockMean[i] /= static_cast<TensorDataType>(blockCount);
+    }
+    for (auto row = firstRow; row < lastRow; ++row) {
+      if (rowMask && rowMask[row] != selectedValue) {
+        continue;
+      }
+      auto rowValues = values + row * static_cast<int64_t>(numberOfColumns);
+      for (size_t i = 0; i < numberOfColumns; ++i) {
+        auto difference = rowValues[i] - blockMean[i];
+        blockM2[i] += difference * difference;
+      }
+    }
+
+    merge(blockCount, blockMinimum.data(), blockMaximum.data(), blockMean.data(), blockM2.data());
+  }
+}
+
+void ColumnStatistics::merge(ColumnStatistics const& other)
+{
+  if (other.count == 0) {
+    return;
+  }
+  if (count == 0) {
+    *this = other;
+    return;
+  }
+  merge(other.count, other.minimum.data(), other.maximum.data(), other.mean.data(), other.m2.data());
+}
+
+void ColumnStatistics::merge(uint64_t const otherCount, TensorDataType const* otherMinimum, TensorDataType const* otherMaximum,
+                             TensorDataType const* otherMean, TensorDataType const* otherM2)
+{
+  if (otherCount == 0) {
+    return;
+  }
+
+  // Combine mean and sum of the squared differences of both parts (Chan et al.):
+  auto totalCount = static_cast<TensorDataType>(count + otherCount);
+  auto otherWeight = static_cast<TensorDataType>(otherCount) / totalCount;
+  auto m2Weight = static_cast<TensorDataType>(count) * otherWeight;
+  for (size_t i = 0; i < getNumberOfColumns(); ++i) {
+    auto delta = otherMean[i] - mean[i];
+    minimum[i] = (count == 0) ? otherMinimum[i] : std::min(minimum[i], otherMinimum[i]);
+    maximum[i] = (count == 0) ? otherMaximum[i] : std::max(maximum[i], otherMaximum[i]);
+    mean[i] += delta * otherWeight;
+    m2[i] += otherM2[i] + delta * delta * m2Weight;
+  }
+  count += otherCount;
+}
+
+uint64_t ColumnStatistics::getCount() const
+{
+  return count;
+}
+
+size_t ColumnStatistics::getNumberOfColumns() const
+{
+  return minimum.size();
+}
+
+TensorDataType ColumnStatistics::getMinimum(size_t const column) const
+{
+  return minimum[column];
+}
+
+TensorDataType ColumnStatistics::getMaximum(size_t const column) const
+{
+  return maximum[column];
+}
+
+TensorDataType ColumnStatistics::getMean(size_t const column) const
+{
+  return mean[column];
+}
+
+TensorDataType ColumnStatistics::getVariance(size_t const column) const
+{
+  return (count > 0) ? m2[column] / static_cast<TensorDataType>(count) : 0.0;
+}
+
+MinMaxVector ColumnStatistics::getMinMaxVector() const
+{
+  MinMaxVector minMaxVector{};
+  if (count == 0) {
+    return minMaxVector;
+  }
+
+  for (size_t i = 0; i < getNumberOfColumns(); ++i) {
+    minMaxVector.emplace_back(minimum[i], maximum[i]);
+  }
+  return minMaxVector;
+}
+
+void DatasetStatistics::merge(DatasetStatistics const& other)
+{
+  inputs.merge(other.inputs);
+  outputs.merge(other.outputs);
+}
+
+MinMaxValues DatasetStatistics::getMinMax() const
+{
+  return std::make_pair(inputs.getMinMaxVector(), outputs.getMinMaxVector());
+}
+
+void MixedDatasetStatistics::merge(MixedDatasetStatistics const& other)
+{
+  inputs.merge(other.inputs);
+  outputsBelowOrEqualThreshold.merge(other.outputsBelowOrEqualThreshold);
+  outputsAboveThreshold.merge(other.outputsAboveThreshold);
+}
+
+MixedMinMaxValues MixedDatasetStatistics::getMixedMinMax() const
+{
+  // Only the min/max values of the output columns are split:
+  auto inputMinMax = inputs.getMinMaxVector();
+  return std::make_pair(std::make_pair(inputMinMax, outputsBelowOrEqualThreshold.getMinMaxVector()),
+                        std::make_pair(inputMinMax, outputsAboveThreshold.getMinMaxVector()));
+}
+
+}
@@ -0,0 +1,130 @@
+#include "Utilities/compactencoding.h"
+
+#include <cmath>
+
+namespace Utilities {
+
+namespace {
+
+const TensorDataType MAXIMUM_CODE = 32767.0; // codes in [-MAXIMUM_CODE, MAXIMUM_CODE], so the center of a range is encoded exactly
+const TensorDataType MAXIMUM_FLOAT16_VALUE = 65504.0;
+
+/*
+ * Decodes a row of fixed point codes. The loop over the columns is vectorized by the compiler.
+ */
+template<class Value>
+inline void decodeRow(int16_t const* codes, Value* values, TensorDataType const* scale, TensorDataType const* offset, int64_t numberOfColumns)
+{
+  for (int64_t i = 0; i < numberOfColumns; ++i) {
+    values[i] = static_cast<Value>(static_cast<TensorDataType>(codes[i]) * scale[i] + offset[i]);
+  }
+}
+
+}
+
+CompactEncoding::CompactEncoding(Format const format_, MinMaxValues const& valueRanges) :
+  format(format_)
+{
+  if (format == Format::Fixed16) {
+    inputEncoding = CreateEncoding(valueRanges.first);
+    outputEncoding = CreateEncoding(valueRanges.second);
+  }
+}
+
+torch::ScalarType CompactEncoding::getCodeType() const
+{
+  return (format == Format::Float16) ? torch::kHalf : torch::kInt16;
+}
+
+torch::Tensor CompactEncoding::encode(torch::Tensor const& values, bool const isOutput) const
+{
+  auto buffer = values.to(TORCH_DATA_TYPE).contiguous();
+  auto numberOfRows = buffer.size(0);
+  auto numberOfColumns = buffer.size(1);
+  auto valuePointer = buffer.data_ptr<TensorDataType>();
+
+  // A saturated code would hide invalid data, so values which cannot be encoded are rejected:
+  for (int64_t row = 0; row < numberOfRows; ++row) {
+    for (int64_t i = 0; i < numberOfColumns; ++i) {
+      auto value = valuePointer[row * numberOfColumns + i];
+      if (!std::isfinite(value) || (format == Format::Float16 && std::abs(value) > MAXIMUM_FLOAT16_VALUE)) {
+        throw std::runtime_error("the normalized " + std::string(isOutput ? "output" : "input") + " value " + std::to_string(value) + " of data point " +
+                                 std::to_string(row + 1) + " cannot be encoded in the compact storage");
+      }
+    }
+  }
+
+  if (format == Format::Float16) {
+    return buffer.to(getCodeType());
+  }
+
+  auto const& encoding = isOutput ? outputEncoding : inputEncoding;
+  auto codes = torch::empty({numberOfRows, numberOfColumns}, getCodeType());
+  auto codePointer = codes.data_ptr<int16_t>();
+  for (int64_t row = 0; row < numberOfRows; ++row, valuePointer += numberOfColumns, codePointer += numberOfColumns) {
+    for (int64_t i = 0; i < numberOfColumns; ++i) {
+      auto code = (encoding.scale[i] > 0.0) ? std::nearbyint((valuePointer[i] - encoding.offset[i]) / encoding.scale[i]) : 0.0;
+      codePointer[i] = static_cast<int16_t>(std::max(-MAXIMUM_CODE, std::min(MAXIMUM_CODE, code)));
+    }
+  }
+  return codes;
+}
+
+torch::Tensor CompactEncoding::decode(torch::Tensor const& codes, bool const isOutput, torch::ScalarType const dataType) const
+{
+  if (format == Format::Float16) {
+    return codes.to(dataType);
+  }
+
+  // A single pass over contiguous codes:
+  auto const& encoding = isOutput ? outputEncoding : inputEncoding;
+  auto rows = ((codes.dim() == 1) ? codes.unsqueeze(0) : codes).contiguous();
+  auto numberOfColumns = rows.size(1);
+  auto values = torch::empty({rows.size(0), numberOfColumns}, TORCH_DATA_TYPE);
+  auto codePointer = rows.data_ptr<int16_t>();
+  auto valuePointer = values.data_ptr<TensorDataType>();
+  for (int64_t row = 0; row < rows.size(0); ++row, codePointer += numberOfColumns, valuePointer += numberOfColumns) {
+    decodeRow(codePointer, valuePointer, encoding.scale.data(), encoding.offset.data(), numberOfColumns);
+  }
+  return values.view(codes.sizes()).to(dataType);
+}
+
+void CompactEncoding::decodeRows(torch::Tensor const& codes, int64_t const* rows, size_t const numberOfRows, bool const isOutput, torch::Tensor& values) const
+{
+  auto target = values.narrow(0, 0, static_cast<int64_t>(numberOfRows));
+  auto valueType = values.scalar_type();
+  if (format == Format::Float16 || (valueType != torch::kFloat && valueType != torch::kDouble) || codes.stride(1) != 1) {
+    // The index tensor is only used during the call, so it can refer to the given rows:
+    auto indices = torch::from_blob(const_cast<int64_t*>(rows), {static_cast<int64_t>(numberOfRows)}, torch::kLong);
+    target.copy_(decode(codes.index_select(0, indices), isOutput, valueType));
+    return;
+  }
+
+  // Each row is decoded directly from the code matrix into the target matrix:
+  auto const& encoding = isOutput ? outputEncoding : inputEncoding;
+  auto numberOfColumns = codes.size(1);
+  auto rowStride = codes.stride(0);
+  auto codePointer = codes.data_ptr<int16_t>();
+  auto decodeAll = [&](auto* valuePointer) {
+    for (size_t row = 0; row < numberOfRows; ++row, valuePointer += numberOfColumns) {
+      decodeRow(codePointer + rows[row] * rowStride, valuePointer, encoding.scale.data(), encoding.offset.data(), numberOfColumns);
+    }
+  };
+  if (valueType == torch::kFloat) {
+    decodeAll(target.data_ptr<float>());
+  } else {
+    decodeAll(target.data_ptr<double>());
+  }
+}
+
+CompactEncoding::FixedPointEncoding CompactEncoding::CreateEncoding(MinMaxVector const& valueRanges)
+{
+  FixedPointEncoding encoding{};
+  for (auto const& [min, max] : valueRanges) {
+    encoding.scale.push_back((max - min) / (2.0 * MAXIMUM_CODE));
+    encoding.offset.push_back(min + (max - min) / 2.0);
+  }
+  return encoding;
+}
+
+}
@@ -0,0 +1,329 @@
+#include "Utilities/compressedfilereader.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef NNAPPROXIMATOR_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef NNAPPROXIMATOR_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace Utilities {
+
+namespace {
+
+const size_t NUMBER_OF_BLOCKS = 4;
+const size_t BLOCK_SIZE = 4 << 20;
+const size_t INPUT_BUFFER_SIZE = 1 << 20;
+
+const unsigned char GZIP_MAGIC_NUMBER[] = {0x1f, 0x8b};
+const unsigned char ZSTD_MAGIC_NUMBER[] = {0x28, 0xb5, 0x2f, 0xfd};
+
+/*
+ * Reads the compressed input file in chunks.
+ */
+class InputBuffer
+{
+public:
+  explicit InputBuffer(FilePath const& path) : file(path, std::ios::binary), buffer(INPUT_BUFFER_SIZE)
+  {
+    if (!file) {
+      throw std::runtime_error("Unable to open the file.");
+    }
+  }
+
+  /*
+   * Reads the next chunk, if the current one is used up. Returns false at the end of the file.
+   */
+  bool fill()
+  {
+    if (position < size) {
+      return true;
+    }
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    size = static_cast<size_t>(file.gcount());
+    position = 0;
+    return size > 0;
+  }
+
+  char* data() { return buffer.data() + position; }
+  size_t available() const { return size - position; }
+  void consume(size_t numberOfBytes) { position += numberOfBytes; }
+
+private:
+  std::ifstream file;
+  std::vector<char> buffer;
+  size_t size = 0;
+  size_t position = 0;
+};
+
+#ifdef NNAPPROXIMATOR_WITH_ZLIB
+class GzipDecoder : public CompressedFileReader::Decoder
+{
+public:
+  explicit GzipDecoder(FilePath const& path) : input(path)
+  {
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) { // 15 + 32: maximum window size, detect gzip/zlib header automatically
+      throw std::runtime_error("Unable to initialize zlib.");
+    }
+  }
+
+  ~GzipDecoder() override
+  {
+    inflateEnd(&stream);
+  }
+
+  size_t decompress(char* output, size_t capacity) override
+  {
+    stream.next_out = reinterpret_cast<Bytef*>(output);
+    stream.avail_out = static_cast<uInt>(capacity);
+
+    while (stream.avail_out > 0) {
+      if (!input.fill()) {
+        if (insideMember) {
+          throw std::runtime_error("Unexpected end of gzip data.");
+        }
+        break;
+      }
+      stream.next_in = reinterpret_cast<Bytef*>(input.data());
+      stream.avail_in = static_cast<uInt>(input.available());
+
+      auto result = inflate(&stream, Z_NO_FLUSH);
+      input.consume(input.available() - stream.avail_in);
+      insideMember = true;
+
+      if (result == Z_STREAM_END) {
+        inflateReset(&stream); // the file can consist of several concatenated gzip members
+        insideMember = false;
+      } else if (result != Z_OK && result != Z_BUF_ERROR) {
+        throw std::runtime_error(std::string("Invalid gzip data: ") + (stream.msg != nullptr ? stream.msg : std::to_string(result)));
+      }
+    }
+
+    return capacity - stream.avail_out;
+  }
+
+private:
+  InputBuffer input;
+  z_stream stream{};
+  bool insideMember = false;
+};
+#endif
+
+#ifdef NNAPPROXIMATOR_WITH_ZSTD
+class ZstdDecoder : public CompressedFileReader::Decoder
+{
+public:
+  explicit ZstdDecoder(FilePath const& path) : input(path), stream(ZSTD_createDStream())
+  {
+    if (stream == nullptr || ZSTD_isError(ZSTD_initDStream(stream))) {
+      throw std::runtime_error("Unable to initialize zstd.");
+    }
+  }
+
+  ~ZstdDecoder() override
+  {
+    ZSTD_freeDStream(stream);
+  }
+
+  size_t decompress(char* output, size_t capacity) override
+  {
+    ZSTD_outBuffer outputBuffer{output, capacity, 0};
+
+    while (outputBuffer.pos < outputBuffer.size) {
+      if (!input.fill()) {
+        if (insideFrame) {
+          throw std::runtime_error("Unexpected end of zstd data.");
+        }
+        break;
+      }
+      ZSTD_inBuffer inputBuffer{input.data(), input.available(), 0};
+      auto result = ZSTD_decompressStream(stream, &outputBuffer, &inputBuffer);
+      input.consume(inputBuffer.pos);
+
+      if (ZSTD_isError(result)) {
+        throw std::runtime_error(std::string("Invalid zstd data: ") + ZSTD_getErrorName(result));
+      }
+      insideFrame = (result != 0); // 0: the current frame is completely decoded
+    }
+
+    return outputBuffer.pos;
+  }
+
+private:
+  InputBuffer input;
+  ZSTD_DStream* stream;
+  bool insideFrame = false;
+};
+#endif
+
+}
+
+CompressedFileReader::Format CompressedFileReader::DetectFormat(FilePath const& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  char magicNumber[sizeof(ZSTD_MAGIC_NUMBER)] = {};
+  file.read(magicNumber, sizeof(magicNumber));
+  return DetectFormat(magicNumber, static_cast<size_t>(file.gcount()));
+}
+
+CompressedFileReader::Format CompressedFileReader::DetectFormat(char const* data, size_t const size)
+{
+  if (size >= sizeof(GZIP_MAGIC_NUMBER) && std::memcmp(data, GZIP_MAGIC_NUMBER, sizeof(GZIP_MAGIC_NUMBER)) == 0) {
+    return Format::Gzip;
+  }
+  if (size >= sizeof(ZSTD_MAGIC_NUMBER) && std::memcmp(data, ZSTD_MAGIC_NUMBER, sizeof(ZSTD_MAGIC_NUMBER)) == 0) {
+    return Format::Zstd;
+  }
+  return Format::Uncompressed;
+}
+
+bool CompressedFileReader::IsSupported(Format const format)
+{
+  switch (format) {
+    case Format::Uncompressed:
+      return false;
+    case Format::Gzip:
+#ifdef NNAPPROXIMATOR_WITH_ZLIB
+      return true;
+#else
+      return false;
+#endif
+    case Format::Zstd:
+#ifdef NNAPPROXIMATOR_WITH_ZSTD
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+std::string CompressedFileReader::GetFormatName(Format const format)
+{
+  switch (format) {
+    case Format::Uncompressed:
+      return "uncompressed";
+    case Format::Gzip:
+      return "gzip";
+    case Format::Zstd:
+      return "zstd";
+  }
+  return {};
+}
+
+CompressedFileReader::CompressedFileReader(FilePath const& path, Format const format)
+{
+  (void) path; // unused if the program is built without any decompression library
+  try {
+#ifdef NNAPPROXIMATOR_WITH_ZLIB
+    if (format == Format::Gzip) {
+      decoder = std::make_unique<GzipDecoder>(path);
+    }
+#endif
+#ifdef NNAPPROXIMATOR_WITH_ZSTD
+    if (format == Format::Zstd) {
+      decoder = std::make_unique<ZstdDecoder>(path);
+    }
+#endif
+    if (!decoder) {
+      throw std::runtime_error("The " + GetFormatName(format) + " format is not supported by this build.");
+    }
+  } catch (std::exception const& e) {
+    error = e.what();
+    endOfFile = true;
+    return;
+  }
+
+  for (size_t i = 0; i < NUMBER_OF_BLOCKS; ++i) {
+    freeBlocks.emplace_back();
+  }
+  decompressionThread = std::thread(&CompressedFileReader::decompressFile, this);
+}
+
+CompressedFileReader::~CompressedFileReader()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopRequested = true;
+  }
+  blockAvailable.notify_all();
+
+  if (decompressionThread.joinable()) {
+    decompressionThread.join();
+  }
+}
+
+bool CompressedFileReader::readBlock(std::vector<char>& block)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (block.capacity() > 0) {
+    freeBlocks.emplace_back(std::move(block));
+    block = std::vector<char>();
+    blockAvailable.notify_all();
+  }
+
+  blockAvailable.wait(lock, [this]() { return !filledBlocks.empty() || endOfFile; });
+  if (filledBlocks.empty() || !error.empty()) {
+    return false;
+  }
+
+  block = std::move(filledBlocks.front());
+  filledBlocks.pop_front();
+  blockAvailable.notify_all();
+  return true;
+}
+
+std::string CompressedFileReader::getError() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return error;
+}
+
+void CompressedFileReader::decompressFile()
+{
+  while (true) {
+    std::vector<char> block{};
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      blockAvailable.wait(lock, [this]() { return !freeBlocks.empty() || stopRequested; });
+      if (stopRequested) {
+        return;
+      }
+      block = std::move(freeBlocks.front());
+      freeBlocks.pop_front();
+    }
+
+    // Decompress without holding the lock, so that the parsing of the previous block continues in parallel:
+    std::string decompressionError{};
+    block.resize(BLOCK_SIZE);
+    size_t size = 0;
+    try {
+      for (size_t bytes = 1; size < block.size() && bytes > 0; size += bytes) {
+        bytes = decoder->decompress(block.data() + size, block.size() - size);
+      }
+    } catch (std::exception const& e) {
+      decompressionError = e.what();
+    }
+    block.resize(size);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!decompressionError.empty()) {
+      error = decompressionError;
+      endOfFile = true;
+    } else if (size == 0) {
+      endOfFile = true;
+    } else {
+      filledBlocks.emplace_back(std::move(block));
+    }
+    blockAvailable.notify_all();
+
+    if (endOfFile) {
+      return;
+    }
+  }
+}
+
+}
@@ -0,0 +1,102 @@
+#include "Utilities/dataloader.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Utilities {
+
+DataLoader::DataLoader(Dataset const& data_, size_t const batchSize_, std::mt19937_64* randomGenerator) :
+  data(data_), batchSize(std::max<size_t>(batchSize_, 1)), numberOfBatches((data_.size() + batchSize - 1) / batchSize)
+{
+  if (numberOfBatches == 0) {
+    return;
+  }
+
+  order.resize(data.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (randomGenerator) {
+    std::shuffle(order.begin(), order.end(), *randomGenerator);
+  }
+
+  // The buffers are allocated once and reused for all batches (the rows of a compact dataset are decoded into them):
+  auto rowsPerBuffer = static_cast<int64_t>(std::min(batchSize, data.size()));
+  for (auto& buffer : buffers) {
+    buffer.inputs = torch::empty({rowsPerBuffer, data.getNumberOfInputVariables()}, data.getDataType());
+    buffer.outputs = torch::empty({rowsPerBuffer, data.getNumberOfOutputVariables()}, data.getDataType());
+  }
+
+  gatheringThread = std::thread([this]() { gatherBatches(); });
+}
+
+DataLoader::~DataLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopGathering = true;
+  }
+  bufferChanged.notify_all();
+  if (gatheringThread.joinable()) {
+    gatheringThread.join();
+  }
+}
+
+std::optional<std::pair<torch::Tensor, torch::Tensor>> DataLoader::next()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  // The previous batch is not used anymore, so its buffer can be filled again:
+  if (bufferInUse) {
+    buffers[*bufferInUse].filled = false;
+    bufferInUse.reset();
+    bufferChanged.notify_all();
+  }
+  if (nextBatch >= numberOfBatches) {
+    return std::nullopt;
+  }
+
+  auto& buffer = buffers[nextBatch % NUMBER_OF_BUFFERS];
+  bufferChanged.wait(lock, [this, &buffer]() { return buffer.filled || gatheringError; });
+  if (gatheringError) {
+    std::rethrow_exception(gatheringError);
+  }
+
+  bufferInUse = nextBatch % NUMBER_OF_BUFFERS;
+  ++nextBatch;
+  return std::make_optional(std::make_pair(buffer.inputs.narrow(0, 0, buffer.numberOfRows), buffer.outputs.narrow(0, 0, buffer.numberOfRows)));
+}
+
+void DataLoader::gatherBatches()
+{
+  try {
+    for (size_t batch = 0; batch < numberOfBatches; ++batch) {
+      auto& buffer = buffers[batch % NUMBER_OF_BUFFERS];
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        bufferChanged.wait(lock, [this, &buffer]() { return !buffer.filled || stopGathering; });
+        if (stopGathering) {
+          return;
+        }
+      }
+
+      // The buffer is neither used nor filled, so it is gathered without holding the lock:
+      auto firstRow = batch * batchSize;
+      auto numberOfRows = std::min(batchSize, order.size() - firstRow);
+      data.gatherRows(order.data() + firstRow, numberOfRows, buffer.inputs, buffer.outputs);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.numberOfRows = static_cast<int64_t>(numberOfRows);
+        buffer.filled = true;
+      }
+      bufferChanged.notify_all();
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      gatheringError = std::current_exception();
+    }
+    bufferChanged.notify_all();
+  }
+}
+
+}
@@ -1,56 +1,166 @@
 #include "Utilities/dataprocessor.h"
-#include "Utilities/datasplitter.h"
 #include "Utilities/fileparser.h"
+#include "Utilities/parallel.h"
 
 namespace Utilities {
 
 namespace {
 
 const TensorDataType MINIMUM_ALLOWED_VALUE = 1e-30;
+const int64_t ROWS_PER_TASK = 1 << 14;
+const int64_t ROWS_PER_BLOCK = 64; // the column parameters are repeated for a block of rows, so the inner loops run over contiguous values
+
+/*
+ * Calls the given function for consecutive parts of the rows of the given matrix with a pointer to the values of the first row and the number of rows.
+ * The function works on a contiguous row-major buffer, which is copied back into the matrix afterwards, if the matrix is not contiguous
+ * or has another data type. The parts are processed in parallel with the given number of threads.
+ */
+template<class Function>
+void transformRows(torch::Tensor& matrix, uint32_t numberOfThreads, Function const& function)
+{
+  if (matrix.numel() == 0) return;
+
+  auto buffer = matrix.to(TORCH_DATA_TYPE).contiguous();
+  auto numberOfColumns = matrix.size(-1);
+  auto numberOfRows = matrix.numel() / numberOfColumns;
+  auto values = buffer.data_ptr<TensorDataType>();
+
+  auto numberOfTasks = static_cast<size_t>((numberOfRows + ROWS_PER_TASK - 1) / ROWS_PER_TASK);
+  runInParallel(numberOfTasks, numberOfThreads, [values, numberOfRows, numberOfColumns, &function](size_t task) {
+    auto firstRow = static_cast<int64_t>(task) * ROWS_PER_TASK;
+    function(values + firstRow * numberOfColumns, std::min(ROWS_PER_TASK, numberOfRows - firstRow));
+  });
 
+  if (!buffer.is_same(matrix)) {
+    matrix.copy_(buffer);
+  }
 }
 
-void DataProcessor::CalculateMinMax(DataVector const& data, MinMaxValues& minMaxVectors)
+/*
+ * Applies the given function to each value of the matrix.
+ */
+template<class Function>
+void transformValues(torch::Tensor& matrix, uint32_t numberOfThreads, Function const& function)
 {
-  if (data.empty()) return;
-  auto& inputMinMax = minMaxVectors.first;
-  auto& outputMinMax = minMaxVectors.second;
-  auto numberOfInputNodes = data.front().first.size(0);
-  auto numberOfOutputNodes = data.front().second.size(0);
-
-  // Initialize minMaxVectors:
-  inputMinMax = MinMaxVector(numberOfInputNodes, std::make_pair(std::numeric_limits<TensorDataType>::max(), std::numeric_limits<TensorDataType>::lowest()));
-  outputMinMax = MinMaxVector(numberOfOutputNodes, std::make_pair(std::numeric_limits<TensorDataType>::max(), std::numeric_limits<TensorDataType>::lowest()));
-
-  // Calculate min and max:
-  for (auto& [inputTensor, outputTensor] : data) {
-    for (int64_t i = 0; i < numberOfInputNodes; ++i) {
-      inputMinMax[i].first = std::min(inputMinMax[i].first, inputTensor[i].item<TensorDataType>());
-      inputMinMax[i].second = std::max(inputMinMax[i].second, inputTensor[i].item<TensorDataType>());
+  auto numberOfColumns = matrix.numel() > 0 ? matrix.size(-1) : 0;
+  transformRows(matrix, numberOfThreads, [numberOfColumns, &function](TensorDataType* values, int64_t numberOfRows) {
+    auto numberOfValues = numberOfRows * numberOfColumns;
+    for (int64_t i = 0; i < numberOfValues; ++i) {
+      values[i] = function(values[i]);
     }
+  });
+}
+
+/*
+ * Applies the given function to each value of the matrix together with the parameters (a, b) of its column.
+ */
+template<class Function>
+void transformColumns(torch::Tensor& matrix, std::vector<TensorDataType> const& columnParametersA, std::vector<TensorDataType> const& columnParametersB,
+                      uint32_t numberOfThreads, Function const& function)
+{
+  auto numberOfColumns = static_cast<int64_t>(columnParametersA.size());
+  std::vector<TensorDataType> blockParametersA(static_cast<size_t>(ROWS_PER_BLOCK * numberOfColumns));
+  std::vector<TensorDataType> blockParametersB(blockParametersA.size());
+  for (size_t i = 0; i < blockParametersA.size(); ++i) {
+    blockParametersA[i] = columnParametersA[i % columnParametersA.size()];
+    blockParametersB[i] = columnParametersB[i % columnParametersB.size()];
+  }
 
-    for (int64_t i = 0; i < numberOfOutputNodes; ++i) {
-      outputMinMax[i].first = std::min(outputMinMax[i].first, outputTensor[i].item<TensorDataType>());
-      outputMinMax[i].second = std::max(outputMinMax[i].second, outputTensor[i].item<TensorDataType>());
+  transformRows(matrix, numberOfThreads, [numberOfColumns, &blockParametersA, &blockParametersB, &function](TensorDataType* values, int64_t numberOfRows) {
+    TensorDataType const* a = blockParametersA.data();
+    TensorDataType const* b = blockParametersB.data();
+    for (int64_t firstRow = 0; firstRow < numberOfRows; firstRow += ROWS_PER_BLOCK) {
+      auto numberOfValues = std::min(ROWS_PER_BLOCK, numberOfRows - firstRow) * numberOfColumns;
+      TensorDataType* blockValues = values + firstRow * numberOfColumns;
+      for (int64_t i = 0; i < numberOfValues; ++i) {
+        blockValues[i] = function(blockValues[i], a[i], b[i]);
+      }
     }
+  });
+}
+
+/*
+ * Calculates statistics of the rows [0, numberOfRows) in parallel. The given function adds a part of the rows to the statistics of a task,
+ * the statistics of all tasks are merged in the order of the rows.
+ */
+template<class Statistics, class Function>
+Statistics calculateStatisticsInParallel(int64_t numberOfRows, uint32_t numberOfThreads, Statistics const& emptyStatistics, Function const& function)
+{
+  auto numberOfTasks = static_cast<size_t>((numberOfRows + ROWS_PER_TASK - 1) / ROWS_PER_TASK);
+  std::vector<Statistics> partialStatistics(numberOfTasks, emptyStatistics);
+  runInParallel(numberOfTasks, numberOfThreads, [numberOfRows, &partialStatistics, &function](size_t task) {
+    auto firstRow = static_cast<int64_t>(task) * ROWS_PER_TASK;
+    function(partialStatistics[task], firstRow, std::min(ROWS_PER_TASK, numberOfRows - firstRow));
+  });
+
+  auto statistics = emptyStatistics;
+  for (auto const& partial : partialStatistics) {
+    statistics.merge(partial);
   }
+  return statistics;
+}
+
 }
 
-void DataProcessor::CalculateMixedMinMax(DataVector const& data, uint32_t thresholdVariable, TensorDataType threshold, MixedMinMaxValues& mixedMinMaxValues)
+DatasetStatistics DataProcessor::CalculateStatistics(Dataset const& data, uint32_t const numberOfThreads)
 {
-  mixedMinMaxValues = std::make_pair(MinMaxValues(), MinMaxValues());
+  if (data.empty()) return {};
+
+  auto inputs = data.inputs().to(TORCH_DATA_TYPE).contiguous();
+  auto outputs = data.outputs().to(TORCH_DATA_TYPE).contiguous();
+  auto inputValues = inputs.data_ptr<TensorDataType>();
+  auto outputValues = outputs.data_ptr<TensorDataType>();
+  auto numberOfInputs = inputs.size(1);
+  auto numberOfOutputs = outputs.size(1);
+
+  DatasetStatistics emptyStatistics{ColumnStatistics(static_cast<size_t>(numberOfInputs)), ColumnStatistics(static_cast<size_t>(numberOfOutputs))};
+  return calculateStatisticsInParallel(static_cast<int64_t>(data.size()), numberOfThreads, emptyStatistics,
+    [=](DatasetStatistics& statistics, int64_t firstRow, int64_t numberOfRows) {
+      statistics.inputs.addRows(inputValues + firstRow * numberOfInputs, numberOfRows);
+      statistics.outputs.addRows(outputValues + firstRow * numberOfOutputs, numberOfRows);
+    });
+}
 
-  auto splitData = DataSplitter::splitDataWithThreshold(data, thresholdVariable, threshold);
+MixedDatasetStatistics DataProcessor::CalculateMixedStatistics(Dataset const& data, uint32_t const thresholdVariable, TensorDataType const threshold,
+                                                               uint32_t const numberOfThreads)
+{
+  if (data.empty()) return {};
+
+  auto inputs = data.inputs().to(TORCH_DATA_TYPE).contiguous();
+  auto outputs = data.outputs().to(TORCH_DATA_TYPE).contiguous();
+  auto inputValues = inputs.data_ptr<TensorDataType>();
+  auto outputValues = outputs.data_ptr<TensorDataType>();
+  auto numberOfInputs = inputs.size(1);
+  auto numberOfOutputs = outputs.size(1);
+
+  MixedDatasetStatistics emptyStatistics{ColumnStatistics(static_cast<size_t>(numberOfInputs)), ColumnStatistics(static_cast<size_t>(numberOfOutputs)),
+                                         ColumnStatistics(static_cast<size_t>(numberOfOutputs))};
+  return calculateStatisticsInParallel(static_cast<int64_t>(data.size()), numberOfThreads, emptyStatistics,
+    [=](MixedDatasetStatistics& statistics, int64_t firstRow, int64_t numberOfRows) {
+      // 1: the row belongs to the region below or equal to the threshold, 0: above the threshold
+      std::vector<uint8_t> regionMask(static_cast<size_t>(numberOfRows));
+      auto thresholdValues = inputValues + firstRow * numberOfInputs + thresholdVariable;
+      for (int64_t row = 0; row < numberOfRows; ++row) {
+        regionMask[static_cast<size_t>(row)] = thresholdValues[row * numberOfInputs] <= threshold;
+      }
+
+      statistics.inputs.addRows(inputValues + firstRow * numberOfInputs, numberOfRows);
+      statistics.outputsBelowOrEqualThreshold.addRows(outputValues + firstRow * numberOfOutputs, numberOfRows, regionMask.data(), 1);
+      statistics.outputsAboveThreshold.addRows(outputValues + firstRow * numberOfOutputs, numberOfRows, regionMask.data(), 0);
+    });
+}
 
-  CalculateMinMax(splitData.first, mixedMinMaxValues.first);
-  CalculateMinMax(splitData.second, mixedMinMaxValues.second);
+void DataProcessor::CalculateMinMax(Dataset const& data, MinMaxValues& minMaxVectors, uint32_t const numberOfThreads)
+{
+  if (data.empty()) return;
 
-  // Only split min/max values for the output tensor:
-  MinMaxValues globalMinMax{};
+  minMaxVectors = CalculateStatistics(data, numberOfThreads).getMinMax();
+}
 
-  CalculateMinMax(data, globalMinMax);
-  mixedMinMaxValues.first.first = globalMinMax.first;
-  mixedMinMaxValues.second.first = globalMinMax.first;
+void DataProcessor::CalculateMixedMinMax(Dataset const& data, uint32_t thresholdVariable, TensorDataType threshold, MixedMinMaxValues& mixedMinMaxValues,
+                                         uint32_t const numberOfThreads)
+{
+  mixedMinMaxValues = CalculateMixedStatistics(data, thresholdVariable, threshold, numberOfThreads).getMixedMinMax();
 }
 
 std::optional<MinMaxValues> DataProcessor::GetMinMaxFromFile(FilePath const& filePath, uint32_t numberOfInputVariables, uint32_t numberOfOutputVariables)
@@ -76,12 +186,12 @@ std::optional<MinMaxValues> DataProcessor::GetMinMaxFromFile(FilePath const& fil
   auto const& fileMinMax = *minMaxOpt;
 
   for (uint32_t j = 0; j < numberOfInputVariables; ++j) {
-    inputMinMax[j].first = fileMinMax[0].first[j].item<TensorDataType>();
-    inputMinMax[j].second = fileMinMax[1].first[j].item<TensorDataType>();
+    inputMinMax[j].first = fileMinMax.input(0)[j].item<TensorDataType>();
+    inputMinMax[j].second = fileMinMax.input(1)[j].item<TensorDataType>();
   }
   for (uint32_t j = 0; j < numberOfOutputVariables; ++j) {
-    outputMinMax[j].first = fileMinMax[0].second[j].item<TensorDataType>();
-    outputMinMax[j].second = fileMinMax[1].second[j].item<TensorDataType>();
+    outputMinMax[j].first = fileMinMax.output(0)[j].item<TensorDataType>();
+    outputMinMax[j].second = fileMinMax.output(1)[j].item<TensorDataType>();
   }
 
   return std::make_optional(minMaxValues);
@@ -116,88 +226,138 @@ std::optional<MixedMinMaxValues> DataProcessor::GetMixedMinMaxFromFile(FilePath
   auto const& fileMinMax = *minMaxOpt;
 
   for (uint32_t j = 0; j < numberOfInputVariables; ++j) {
-    inputMinMax1[j].first = fileMinMax[0].first[j].item<TensorDataType>();
-    inputMinMax1[j].second = fileMinMax[1].first[j].item<TensorDataType>();
-    inputMinMax2[j].first = fileMinMax[2].first[j].item<TensorDataType>();
-    inputMinMax2[j].second = fileMinMax[3].first[j].item<TensorDataType>();
+    inputMinMax1[j].first = fileMinMax.input(0)[j].item<TensorDataType>();
+    inputMinMax1[j].second = fileMinMax.input(1)[j].item<TensorDataType>();
+    inputMinMax2[j].first = fileMinMax.input(2)[j].item<TensorDataType>();
+    inputMinMax2[j].second = fileMinMax.input(3)[j].item<TensorDataType>();
   }
   for (uint32_t j = 0; j < numberOfOutputVariables; ++j) {
-    outputMinMax1[j].first = fileMinMax[0].second[j].item<TensorDataType>();
-    outputMinMax1[j].second = fileMinMax[1].second[j].item<TensorDataType>();
-    outputMinMax2[j].first = fileMinMax[2].second[j].item<TensorDataType>();
-    outputMinMax2[j].second = fileMinMax[3].second[j].item<TensorDataType>();
+    outputMinMax1[j].first = fileMinMax.output(0)[j].item<TensorDataType>();
+    outputMinMax1[j].second = fileMinMax.output(1)[j].item<TensorDataType>();
+    outputMinMax2[j].first = fileMinMax.output(2)[j].item<TensorDataType>();
+    outputMinMax2[j].second = fileMinMax.output(3)[j].item<TensorDataType>();
   }
 
   return std::make_optional(std::make_pair(minMaxValues1, minMaxValues2));
 }
 
-void DataProcessor::Normalize(DataVector& data, std::pair<MinMaxVector const, MinMaxVector const> const& minMaxVectors, TensorDataType const newMinValue, TensorDataType const newMaxValue)
+void DataProcessor::Normalize(Dataset& data, std::pair<MinMaxVector const, MinMaxVector const> const& minMaxVectors, TensorDataType const newMinValue, TensorDataType const newMaxValue,
+                              uint32_t const numberOfThreads)
 {
-  auto const& inputMinMax = minMaxVectors.first;
-  auto const& outputMinMax = minMaxVectors.second;
+  if (data.empty()) return;
 
-  for (auto& [inputTensor, outputTensor] : data) {
-    Normalize(inputTensor, inputMinMax, newMinValue, newMaxValue);
-    Normalize(outputTensor, outputMinMax, newMinValue, newMaxValue);
-  }
+  auto inputs = data.inputs();
+  auto outputs = data.outputs();
+  NormalizeMatrix(inputs, minMaxVectors.first, newMinValue, newMaxValue, numberOfThreads);
+  NormalizeMatrix(outputs, minMaxVectors.second, newMinValue, newMaxValue, numberOfThreads);
+  data.setInputs(inputs);
+  data.setOutputs(outputs);
 }
 
 void DataProcessor::Normalize(torch::Tensor& tensor, MinMaxVector const& minMaxVector, TensorDataType const newMinValue, TensorDataType const newMaxValue)
 {
-  // Normalize data -- use '(X - min) / (max - min)' to get values between 0 and 1:
-  for (int64_t i = 0; i < tensor.size(0); ++i) {
-    TensorDataType normalizationFactor = newMaxValue - newMinValue;
-    tensor[i] = ((tensor[i].item<TensorDataType>() - minMaxVector[i].first) / (minMaxVector[i].second - minMaxVector[i].first)) * normalizationFactor + newMinValue;
-  }
+  NormalizeMatrix(tensor, minMaxVector, newMinValue, newMaxValue);
 }
 
 void DataProcessor::Denormalize(torch::Tensor& tensor, MinMaxVector const& minMaxVector, TensorDataType const oldMinValue, TensorDataType const oldMaxValue, bool const limitValues)
 {
-  if (tensor.size(0) != static_cast<int64_t>(minMaxVector.size())) {
-    return;
-  }
-
-  TensorDataType normalizationFactor = oldMaxValue - oldMinValue;
-  for (size_t i = 0; i < minMaxVector.size(); ++i) {
-    if (limitValues) {
-      tensor[i] = std::max(oldMinValue, (std::min(oldMaxValue, tensor[i].item<TensorDataType>())));
-    }
-    tensor[i] = (((tensor[i] - oldMinValue) / normalizationFactor) * (minMaxVector[i].second - minMaxVector[i].first)) + minMaxVector[i].first;
-  }
+  DenormalizeMatrix(tensor, minMaxVector, oldMinValue, oldMaxValue, limitValues);
 }
 
 void DataProcessor::ScaleLogarithmic(torch::Tensor& data)
 {
-  for (int64_t i = 0; i < data.size(0); ++i) {
-    if (data[i].item<TensorDataType>() < MINIMUM_ALLOWED_VALUE) {
-      data[i] = MINIMUM_ALLOWED_VALUE;
-    }
-    data[i] = std::log(data[i].item<TensorDataType>());
-  }
+  ScaleLogarithmicMatrix(data);
 }
 
 void DataProcessor::UnscaleLogarithmic(torch::Tensor& data)
 {
-  for (int64_t i = 0; i < data.size(0); ++i) {
-    data[i] = std::exp(data[i].item<TensorDataType>());
-  }
+  UnscaleLogarithmicMatrix(data);
 }
 
 void DataProcessor::ScaleSquareRoot(torch::Tensor& data)
 {
-  for (int64_t i = 0; i < data.size(0); ++i) {
-    if (data[i].item<TensorDataType>() < MINIMUM_ALLOWED_VALUE) {
-      data[i] = MINIMUM_ALLOWED_VALUE;
-    }
-    data[i] = std::sqrt(data[i].item<TensorDataType>());
-  }
+  ScaleSquareRootMatrix(data);
 }
 
 void DataProcessor::UnscaleSquareRoot(torch::Tensor& data)
 {
-  for (int64_t i = 0; i < data.size(0); ++i) {
-    data[i] = std::pow(data[i].item<TensorDataType>(), 2.0);
+  UnscaleSquareRootMatrix(data);
+}
+
+void DataProcessor::NormalizeMatrix(torch::Tensor& matrix, MinMaxVector const& minMaxVector, TensorDataType const newMinValue, TensorDataType const newMaxValue,
+                                    uint32_t const numberOfThreads)
+{
+  if (matrix.numel() == 0 || matrix.size(-1) != static_cast<int64_t>(minMaxVector.size())) {
+    return;
+  }
+
+  std::vector<TensorDataType> minValues{};
+  std::vector<TensorDataType> ranges{};
+  for (auto const& [min, max] : minMaxVector) {
+    minValues.push_back(min);
+    ranges.push_back(max - min);
   }
+
+  // Normalize data -- use '(X - min) / (max - min)' to get values between 0 and 1:
+  TensorDataType normalizationFactor = newMaxValue - newMinValue;
+  transformColumns(matrix, minValues, ranges, numberOfThreads, [normalizationFactor, newMinValue](TensorDataType value, TensorDataType min, TensorDataType range) {
+    return ((value - min) / range) * normalizationFactor + newMinValue;
+  });
+}
+
+void DataProcessor::DenormalizeMatrix(torch::Tensor& matrix, MinMaxVector const& minMaxVector, TensorDataType const oldMinValue, TensorDataType const oldMaxValue,
+                                      bool const limitValues, uint32_t const numberOfThreads)
+{
+  if (matrix.numel() == 0 || matrix.size(-1) != static_cast<int64_t>(minMaxVector.size())) {
+    return;
+  }
+
+  std::vector<TensorDataType> minValues{};
+  std::vector<TensorDataType> ranges{};
+  for (auto const& [min, max] : minMaxVector) {
+    minValues.push_back(min);
+    ranges.push_back(max - min);
+  }
+
+  TensorDataType normalizationFactor = oldMaxValue - oldMinValue;
+  if (limitValues) {
+    transformColumns(matrix, minValues, ranges, numberOfThreads, [normalizationFactor, oldMinValue, oldMaxValue](TensorDataType value, TensorDataType min, TensorDataType range) {
+      value = std::max(oldMinValue, std::min(oldMaxValue, value));
+      return (((value - oldMinValue) / normalizationFactor) * range) + min;
+    });
+  } else {
+    transformColumns(matrix, minValues, ranges, numberOfThreads, [normalizationFactor, oldMinValue](TensorDataType value, TensorDataType min, TensorDataType range) {
+      return (((value - oldMinValue) / normalizationFactor) * range) + min;
+    });
+  }
+}
+
+void DataProcessor::ScaleLogarithmicMatrix(torch::Tensor& matrix, uint32_t const numberOfThreads)
+{
+  transformValues(matrix, numberOfThreads, [](TensorDataType value) {
+    return std::log(std::max(value, MINIMUM_ALLOWED_VALUE));
+  });
+}
+
+void DataProcessor::UnscaleLogarithmicMatrix(torch::Tensor& matrix, uint32_t const numberOfThreads)
+{
+  transformValues(matrix, numberOfThreads, [](TensorDataType value) {
+    return std::exp(value);
+  });
+}
+
+void DataProcessor::ScaleSquareRootMatrix(torch::Tensor& matrix, uint32_t const numberOfThreads)
+{
+  transformValues(matrix, numberOfThreads, [](TensorDataType value) {
+    return std::sqrt(std::max(value, MINIMUM_ALLOWED_VALUE));
+  });
+}
+
+void DataProcessor::UnscaleSquareRootMatrix(torch::Tensor& matrix, uint32_t const numberOfThreads)
+{
+  transformValues(matrix, numberOfThreads, [](TensorDataType value) {
+    return value * value;
+  });
 }
 
 }
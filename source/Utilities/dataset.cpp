@@ -0,0 +1,216 @@
+#include "Utilities/dataset.h"
+
+#include "Utilities/compactencoding.h"
+
+Dataset::Dataset(torch::Tensor inputs, torch::Tensor outputs) :
+  inputMatrix(std::move(inputs)), outputMatrix(std::move(outputs))
+{
+}
+
+Dataset Dataset::CreateCompact(int64_t const numberOfRows, int64_t const numberOfInputs, int64_t const numberOfOutputs,
+                               std::shared_ptr<Utilities::CompactEncoding const> encoding, torch::ScalarType const dataType)
+{
+  Dataset result(torch::zeros({numberOfRows, numberOfInputs}, encoding->getCodeType()), torch::zeros({numberOfRows, numberOfOutputs}, encoding->getCodeType()));
+  result.encoding = std::move(encoding);
+  result.valueType = dataType;
+  return result;
+}
+
+size_t Dataset::size() const
+{
+  if (rowIndices) {
+    return rowIndices->size();
+  }
+  return inputMatrix.defined() ? static_cast<size_t>(inputMatrix.size(0)) : 0;
+}
+
+bool Dataset::empty() const
+{
+  return size() == 0;
+}
+
+int64_t Dataset::getNumberOfInputVariables() const
+{
+  return inputMatrix.defined() ? inputMatrix.size(1) : 0;
+}
+
+int64_t Dataset::getNumberOfOutputVariables() const
+{
+  return outputMatrix.defined() ? outputMatrix.size(1) : 0;
+}
+
+torch::Tensor Dataset::input(size_t const row) const
+{
+  return decode(inputMatrix.select(0, getMatrixRow(row)), false);
+}
+
+torch::Tensor Dataset::output(size_t const row) const
+{
+  return decode(outputMatrix.select(0, getMatrixRow(row)), true);
+}
+
+std::pair<torch::Tensor, torch::Tensor> Dataset::operator[](size_t const row) const
+{
+  auto matrixRow = getMatrixRow(row);
+  return std::make_pair(decode(inputMatrix.select(0, matrixRow), false), decode(outputMatrix.select(0, matrixRow), true));
+}
+
+torch::Tensor Dataset::inputs() const
+{
+  return decode(rowIndices ? inputMatrix.index_select(0, getRowIndexTensor()) : inputMatrix, false);
+}
+
+torch::Tensor Dataset::outputs() const
+{
+  return decode(rowIndices ? outputMatrix.index_select(0, getRowIndexTensor()) : outputMatrix, true);
+}
+
+void Dataset::setInputs(torch::Tensor const& values)
+{
+  auto codes = encoding ? encoding->encode(values, false) : values;
+  if (rowIndices) {
+    inputMatrix.index_copy_(0, getRowIndexTensor(), codes);
+  } else if (!codes.is_same(inputMatrix)) {
+    inputMatrix.copy_(codes);
+  }
+}
+
+void Dataset::setOutputs(torch::Tensor const& values)
+{
+  auto codes = encoding ? encoding->encode(values, true) : values;
+  if (rowIndices) {
+    outputMatrix.index_copy_(0, getRowIndexTensor(), codes);
+  } else if (!codes.is_same(outputMatrix)) {
+    outputMatrix.copy_(codes);
+  }
+}
+
+void Dataset::gatherRows(int64_t const* rows, size_t const numberOfRows, torch::Tensor& inputs, torch::Tensor& outputs) const
+{
+  std::vector<int64_t> matrixRows(numberOfRows);
+  for (size_t i = 0; i < numberOfRows; ++i) {
+    matrixRows[i] = getMatrixRow(static_cast<size_t>(rows[i]));
+  }
+
+  if (encoding) {
+    encoding->decodeRows(inputMatrix, matrixRows.data(), numberOfRows, false, inputs);
+    encoding->decodeRows(outputMatrix, matrixRows.data(), numberOfRows, true, outputs);
+    return;
+  }
+
+  auto indices = torch::from_blob(matrixRows.data(), {static_cast<int64_t>(numberOfRows)}, torch::kLong);
+  auto inputRows = inputs.narrow(0, 0, static_cast<int64_t>(numberOfRows));
+  auto outputRows = outputs.narrow(0, 0, static_cast<int64_t>(numberOfRows));
+  torch::index_select_out(inputRows, inputMatrix, 0, indices);
+  torch::index_select_out(outputRows, outputMatrix, 0, indices);
+}
+
+Dataset Dataset::subset(std::vector<int64_t> const& rows) const
+{
+  auto indices = std::make_shared<std::vector<int64_t>>();
+  indices->reserve(rows.size());
+  for (auto row : rows) {
+    indices->push_back(getMatrixRow(static_cast<size_t>(row)));
+  }
+
+  auto result = withMatrices(inputMatrix, outputMatrix);
+  result.rowIndices = std::move(indices);
+  return result;
+}
+
+Dataset Dataset::slice(size_t const begin, size_t const end) const
+{
+  if (!rowIndices) {
+    auto length = static_cast<int64_t>(end - begin);
+    auto result = withMatrices(inputMatrix.narrow(0, static_cast<int64_t>(begin), length), outputMatrix.narrow(0, static_cast<int64_t>(begin), length));
+    result.rowIndices = nullptr;
+    return result;
+  }
+
+  auto result = withMatrices(inputMatrix, outputMatrix);
+  result.rowIndices = std::make_shared<std::vector<int64_t> const>(rowIndices->begin() + static_cast<std::ptrdiff_t>(begin),
+                                                                   rowIndices->begin() + static_cast<std::ptrdiff_t>(end));
+  return result;
+}
+
+bool Dataset::isSubset() const
+{
+  return rowIndices != nullptr;
+}
+
+Dataset Dataset::compact(std::shared_ptr<Utilities::CompactEncoding const> compactEncoding, torch::ScalarType const dataType) const
+{
+  Dataset result(compactEncoding->encode(inputs(), false), compactEncoding->encode(outputs(), true));
+  result.encoding = std::move(compactEncoding);
+  result.valueType = dataType;
+  return result;
+}
+
+bool Dataset::isCompact() const
+{
+  return encoding != nullptr;
+}
+
+torch::ScalarType Dataset::getDataType() const
+{
+  if (encoding) {
+    return valueType;
+  }
+  return inputMatrix.defined() ? inputMatrix.scalar_type() : valueType;
+}
+
+Dataset Dataset::to(torch::ScalarType const dataType) const
+{
+  if (encoding) {
+    auto result = *this;
+    result.valueType = dataType;
+    return result;
+  }
+  return withMatrices(inputMatrix.defined() ? inputMatrix.to(dataType) : inputMatrix, outputMatrix.defined() ? outputMatrix.to(dataType) : outputMatrix);
+}
+
+Dataset Dataset::contiguous() const
+{
+  return withMatrices(inputMatrix.defined() ? inputMatrix.contiguous() : inputMatrix, outputMatrix.defined() ? outputMatrix.contiguous() : outputMatrix);
+}
+
+Dataset Dataset::clone() const
+{
+  return withMatrices(inputMatrix.defined() ? inputMatrix.clone(torch::MemoryFormat::Contiguous) : inputMatrix,
+                      outputMatrix.defined() ? outputMatrix.clone(torch::MemoryFormat::Contiguous) : outputMatrix);
+}
+
+Dataset::Iterator Dataset::begin() const
+{
+  return Iterator(*this, 0);
+}
+
+Dataset::Iterator Dataset::end() const
+{
+  return Iterator(*this, size());
+}
+
+inline int64_t Dataset::getMatrixRow(size_t const row) const
+{
+  return rowIndices ? (*rowIndices)[row] : static_cast<int64_t>(row);
+}
+
+torch::Tensor Dataset::getRowIndexTensor() const
+{
+  // The index tensor is only used during the call, so it can refer to the memory of the index vector:
+  return torch::from_blob(const_cast<int64_t*>(rowIndices->data()), {static_cast<int64_t>(rowIndices->size())}, torch::kLong);
+}
+
+torch::Tensor Dataset::decode(torch::Tensor const& codes, bool const isOutput) const
+{
+  return encoding ? encoding->decode(codes, isOutput, valueType) : codes;
+}
+
+Dataset Dataset::withMatrices(torch::Tensor inputs, torch::Tensor outputs) const
+{
+  Dataset result(std::move(inputs), std::move(outputs));
+  result.rowIndices = rowIndices;
+  result.encoding = encoding;
+  result.valueType = valueType;
+  return result;
+}
@@ -0,0 +1,183 @@
+#include "Utilities/datasetcache.h"
+#include "Utilities/fileparser.h"
+#include "Utilities/mappedfile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+namespace Utilities {
+
+namespace {
+
+const int64_t CACHE_FORMAT_VERSION = 2;
+const std::string CACHE_FILE_EXTENSION = ".nncache";
+
+const uint64_t HASH_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t HASH_PRIME = 1099511628211ull;
+
+/*
+ * FNV-1a hash, which processes 8 bytes per step. Not suitable for cryptographic purposes.
+ */
+uint64_t calculateHash(char const* data, size_t size, uint64_t hash = HASH_OFFSET_BASIS)
+{
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * HASH_PRIME;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * HASH_PRIME;
+  }
+  return hash;
+}
+
+uint64_t calculateHash(std::string const& text, uint64_t hash = HASH_OFFSET_BASIS)
+{
+  return calculateHash(text.data(), text.size(), hash);
+}
+
+/*
+ * Returns the hash of the file content or 0 if the file cannot be read.
+ */
+uint64_t calculateFileHash(FilePath const& path)
+{
+  MappedFile file(path);
+  if (!file.isOpen()) {
+    return 0;
+  }
+  return calculateHash(file.data(), file.size(), calculateHash(std::to_string(file.size())));
+}
+
+std::string toHex(uint64_t value)
+{
+  std::ostringstream stream;
+  stream << std::hex << std::setw(16) << std::setfill('0') << value;
+  return stream.str();
+}
+
+/*
+ * Returns all options which influence the result of the preprocessing as string.
+ */
+std::string getPreprocessingOptions(ProgramOptions const& options)
+{
+  std::ostringstream stream;
+  stream << std::hexfloat
+         << "in=" << options.NumberOfInputVariables << ";out=" << options.NumberOfOutputVariables
+         << ";log=" << options.LogScaling << ";sqrt=" << options.SqrtScaling << ";logLin=" << options.LogLinScaling << ";logSqrt=" << options.LogSqrtScaling
+         << ";mixedVariable=" << options.MixedScalingInputVariable << ";mixedThreshold=" << options.MixedScalingThreshold;
+  if (options.InputMinMaxFilePath != DefaultValues::INPUT_MIN_MAX_FILE_PATH) {
+    stream << ";minMax=" << calculateFileHash(options.InputMinMaxFilePath);
+  }
+  if (options.InputPipelineFilePath != DefaultValues::INPUT_PIPELINE_FILE_PATH) {
+    stream << ";pipeline=" << calculateFileHash(options.InputPipelineFilePath);
+  }
+  return stream.str();
+}
+
+torch::Tensor toTensor(std::string const& text)
+{
+  auto tensor = torch::empty({static_cast<int64_t>(text.size())}, torch::kUInt8);
+  std::memcpy(tensor.data_ptr<uint8_t>(), text.data(), text.size());
+  return tensor;
+}
+
+std::string toString(torch::Tensor const& tensor)
+{
+  auto contiguousTensor = tensor.contiguous();
+  auto characters = reinterpret_cast<char const*>(contiguousTensor.data_ptr<uint8_t>());
+  return std::string(characters, characters + contiguousTensor.numel());
+}
+
+}
+
+DatasetCache::DatasetCache(FilePath directory_, ProgramOptions const& options) :
+  directory(std::move(directory_))
+{
+  std::error_code errorCode{};
+  auto absoluteInputPath = std::filesystem::absolute(options.InputDataFilePath, errorCode).lexically_normal().string();
+  auto contentHash = HASH_OFFSET_BASIS;
+  for (auto const& inputFilePath : FileParser::GetInputFilePaths(options.InputDataFilePath)) {
+    contentHash = calculateHash(inputFilePath, calculateHash(toHex(calculateFileHash(inputFilePath)), contentHash));
+  }
+  auto optionsHash = calculateHash(getPreprocessingOptions(options));
+
+  key = {CACHE_FORMAT_VERSION, static_cast<int64_t>(contentHash), static_cast<int64_t>(optionsHash)};
+  entryPrefix = toHex(calculateHash(absoluteInputPath)) + "-";
+  entryName = entryPrefix + toHex(calculateHash(toHex(contentHash), optionsHash)) + CACHE_FILE_EXTENSION;
+}
+
+std::optional<PreprocessedDataset> DatasetCache::load() const
+{
+  auto path = std::filesystem::path(directory) / entryName;
+  std::error_code errorCode{};
+  if (!std::filesystem::is_regular_file(path, errorCode)) {
+    return std::nullopt;
+  }
+
+  try {
+    torch::serialize::InputArchive archive{};
+    archive.load_from(path.string());
+
+    torch::Tensor storedKey;
+    archive.read("key", storedKey);
+    if (storedKey.numel() != static_cast<int64_t>(key.size()) ||
+        !std::equal(key.begin(), key.end(), storedKey.contiguous().data_ptr<int64_t>())) {
+      return std::nullopt;
+    }
+
+    torch::Tensor inputs, outputs, fileHeader;
+    archive.read("inputs", inputs);
+    archive.read("outputs", outputs);
+    archive.read("fileHeader", fileHeader);
+
+    PreprocessedDataset dataset{};
+    dataset.data = Dataset(inputs, outputs);
+    dataset.fileHeader = toString(fileHeader);
+    dataset.pipeline = TransformPipeline::Read(archive);
+
+    return std::make_optional(std::move(dataset));
+  } catch (std::exception const& e) {
+    std::cout << "[Warning] Ignoring invalid cache entry \"" << path.string() << "\": " << e.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
+void DatasetCache::store(PreprocessedDataset const& dataset) const
+{
+  std::error_code errorCode{};
+  std::filesystem::create_directories(directory, errorCode);
+
+  auto path = std::filesystem::path(directory) / entryName;
+  auto temporaryPath = path;
+  temporaryPath += ".tmp";
+
+  try {
+    torch::serialize::OutputArchive archive{};
+    archive.write("key", torch::tensor(key, torch::kInt64));
+    archive.write("inputs", dataset.data.inputs().contiguous());
+    archive.write("outputs", dataset.data.outputs().contiguous());
+    archive.write("fileHeader", toTensor(dataset.fileHeader));
+    dataset.pipeline.write(archive);
+
+    // Write to a temporary file first, so that concurrent processes never read a partially written entry:
+    archive.save_to(temporaryPath.string());
+    std::filesystem::rename(temporaryPath, path);
+  } catch (std::exception const& e) {
+    std::cout << "[Warning] Unable to store the preprocessed data in the cache: " << e.what() << std::endl;
+    std::filesystem::remove(temporaryPath, errorCode);
+    return;
+  }
+
+  // Remove outdated entries of the same input file:
+  for (auto const& entry : std::filesystem::directory_iterator(directory, errorCode)) {
+    auto fileName = entry.path().filename().string();
+    if (fileName != entryName && fileName.rfind(entryPrefix, 0) == 0 && entry.path().extension() == CACHE_FILE_EXTENSION) {
+      std::filesystem::remove(entry.path(), errorCode);
+    }
+  }
+}
+
+}
@@ -1,64 +1,145 @@
 #include "Utilities/datasplitter.h"
 
+#include <cstring>
 #include <random>
+#include <unordered_map>
 
 namespace Utilities {
 
-std::pair<DataVector, DataVector> DataSplitter::splitDataRandomly(DataVector const& inputData, double trainingPercentage)
+std::pair<Dataset, Dataset> DataSplitter::splitDataRandomly(Dataset const& inputData, double trainingPercentage, uint64_t const seed)
 {
+  return splitDataWithTrainingRows(inputData, 0, getTrainingRowsRandomly(inputData.size(), trainingPercentage, seed));
+}
+
+std::vector<bool> DataSplitter::getTrainingRowsRandomly(uint64_t const numberOfRows, double const trainingPercentage, uint64_t const seed)
+{
+  std::vector<bool> trainingRows(numberOfRows, false);
   if (trainingPercentage == 0) {
-    return std::make_pair(DataVector(), inputData);
+    return trainingRows;
   }
-  DataVector trainingData{};
-  DataVector validationData{};
 
-  std::random_device rd;
-  std::mt19937 gen(rd());
+  std::mt19937_64 gen(seed);
   std::uniform_real_distribution<double> dis(0.0, 100.0);
 
-  for (auto const& entry : inputData) {
-    if (dis(gen) <= trainingPercentage) {
-      trainingData.push_back(entry);
+  for (uint64_t i = 0; i < numberOfRows; ++i) {
+    trainingRows[i] = dis(gen) <= trainingPercentage;
+  }
+
+  return trainingRows;
+}
+
+std::pair<Dataset, Dataset> DataSplitter::splitDataWithTrainingRows(Dataset const& data, uint64_t const firstRow, std::vector<bool> const& trainingRows)
+{
+  std::vector<int64_t> trainingRowIndices{};
+  std::vector<int64_t> validationRowIndices{};
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (trainingRows[firstRow + i]) {
+      trainingRowIndices.push_back(static_cast<int64_t>(i));
     } else {
-      validationData.push_back(entry);
+      validationRowIndices.push_back(static_cast<int64_t>(i));
     }
   }
 
-  return std::make_pair(trainingData, validationData);
+  return std::make_pair(data.subset(trainingRowIndices), data.subset(validationRowIndices));
 }
 
-std::pair<DataVector, DataVector> DataSplitter::splitDataWithThreshold(DataVector const& data, uint32_t const thresholdVariable, TensorDataType const threshold)
+std::pair<Dataset, Dataset> DataSplitter::splitDataWithThreshold(Dataset const& data, uint32_t const thresholdVariable, TensorDataType const threshold)
 {
-  DataVector belowAndEqualThreshold{};
-  DataVector aboveThreshold{};
+  std::vector<int64_t> belowAndEqualThresholdRows{};
+  std::vector<int64_t> aboveThresholdRows{};
 
-  for (auto const& row : data) {
-    if (row.first[thresholdVariable].item<TensorDataType>() <= threshold) {
-      belowAndEqualThreshold.push_back(row);
+  auto column = data.inputs().select(1, thresholdVariable).to(TORCH_DATA_TYPE).contiguous();
+  auto values = column.data_ptr<TensorDataType>();
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (values[i] <= threshold) {
+      belowAndEqualThresholdRows.push_back(static_cast<int64_t>(i));
     } else {
-      aboveThreshold.push_back(row);
+      aboveThresholdRows.push_back(static_cast<int64_t>(i));
     }
   }
 
-  return std::make_pair(belowAndEqualThreshold, aboveThreshold);
+  return std::make_pair(data.subset(belowAndEqualThresholdRows), data.subset(aboveThresholdRows));
 }
 
-BatchMap DataSplitter::splitDataIntoBatches(DataVector const& data, uint32_t const batchVariable) {
-  BatchMap batches{};
+BatchVector DataSplitter::splitDataIntoBatches(Dataset const& data, uint32_t const batchVariable)
+{
+  auto inputs = data.inputs().to(TORCH_DATA_TYPE).contiguous();
+  auto numberOfColumns = inputs.size(1);
+  auto values = inputs.data_ptr<TensorDataType>();
 
-  for (auto const& entry : data) {
-    std::string identifier {};
-    for (int64_t i = 0; i < entry.first.size(0); ++i) {
+  // The identifier of a row are the bits of its values in all columns except the batch variable (-0.0 and 0.0 are equal):
+  auto getBits = [](TensorDataType const value) {
+    TensorDataType normalizedValue = value + 0.0;
+    uint64_t bits = 0;
+    std::memcpy(&bits, &normalizedValue, sizeof(bits));
+    return bits;
+  };
+  auto hashRow = [&](TensorDataType const* row) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int64_t i = 0; i < numberOfColumns; ++i) {
       if (i != batchVariable) {
-        identifier += std::to_string(i) + "->" + std::to_string(entry.first[i].item<TensorDataType>());
+        hash = (hash ^ getBits(row[i])) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+      }
+    }
+    return hash;
+  };
+  auto rowsAreEqual = [&](TensorDataType const* first, TensorDataType const* second) {
+    for (int64_t i = 0; i < numberOfColumns; ++i) {
+      if (i != batchVariable && getBits(first[i]) != getBits(second[i])) {
+        return false;
       }
     }
+    return true;
+  };
 
-    auto result = batches.insert(std::make_pair(identifier, DataVector{entry}));
+  // Assign each row to a batch. Rows with the same hash are compared, so that a hash collision does not merge batches:
+  std::unordered_map<uint64_t, std::vector<size_t>> batchesWithHash{};
+  std::vector<int64_t> firstRowOfBatch{};
+  std::vector<int64_t> batchSizes{};
+  std::vector<size_t> batchOfRow(data.size());
 
-    if (!result.second) {
-      result.first->second.push_back(entry);
+  for (size_t row = 0; row < data.size(); ++row) {
+    auto rowValues = values + static_cast<int64_t>(row) * numberOfColumns;
+    auto& candidates = batchesWithHash[hashRow(rowValues)];
+
+    auto batch = firstRowOfBatch.size();
+    for (auto candidate : candidates) {
+      if (rowsAreEqual(rowValues, values + firstRowOfBatch[candidate] * numberOfColumns)) {
+        batch = candidate;
+        break;
+      }
+    }
+    if (batch == firstRowOfBatch.size()) {
+      candidates.push_back(batch);
+      firstRowOfBatch.push_back(static_cast<int64_t>(row));
+      batchSizes.push_back(0);
     }
+
+    batchOfRow[row] = batch;
+    ++batchSizes[batch];
+  }
+
+  // Order the rows by batch (stable counting sort) and copy them, so that each batch is a range of consecutive rows:
+  std::vector<int64_t> batchOffsets(batchSizes.size() + 1, 0);
+  for (size_t batch = 0; batch < batchSizes.size(); ++batch) {
+    batchOffsets[batch + 1] = batchOffsets[batch] + batchSizes[batch];
+  }
+
+  std::vector<int64_t> orderedRows(data.size());
+  auto nextPosition = batchOffsets;
+  for (size_t row = 0; row < data.size(); ++row) {
+    orderedRows[static_cast<size_t>(nextPosition[batchOfRow[row]]++)] = static_cast<int64_t>(row);
+  }
+
+  auto orderedSubset = data.subset(orderedRows);
+  Dataset orderedData(orderedSubset.inputs(), orderedSubset.outputs());
+
+  BatchVector batches{};
+  batches.reserve(batchSizes.size());
+  for (size_t batch = 0; batch < batchSizes.size(); ++batch) {
+    batches.push_back(orderedData.slice(static_cast<size_t>(batchOffsets[batch]), static_cast<size_t>(batchOffsets[batch + 1])));
   }
 
   return batches;
@@ -1,77 +1,519 @@
+#include "Utilities/compressedfilereader.h"
 #include "Utilities/fileparser.h"
+#include "Utilities/mappedfile.h"
+#include "Utilities/parallel.h"
 
+#include <glob.h>
+
+#include <charconv>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 
 namespace Utilities {
 
-std::optional<DataVector> FileParser::ParseInputFile(std::string const& path, uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes, std::string& fileHeader)
+namespace {
+
+const uint64_t FIRST_DATA_LINE_NUMBER = 2; // line 1 is the file header
+const size_t MINIMUM_BYTES_PER_THREAD = 1 << 20;
+const size_t MAXIMUM_BYTES_PER_RANGE = 16 << 20; // limits the size of a chunk, if the file is read in chunks
+
+struct LineRange
 {
-  auto data = DataVector();
+  char const* begin;
+  char const* end;
+  size_t fileIndex;
+  uint64_t firstLineNumber;
+  size_t firstRow;
+  size_t numberOfRows;
+};
 
-  if (path.empty()) {
-    std::cout << "Error: \"" << path << "\" is not a valid path to a file for the input data." << std::endl;
+struct ParseError
+{
+  uint64_t lineNumber;
+  bool inOutputPart;
+};
+
+inline bool isSeparator(char const c)
+{
+  return c == ',' || c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline char const* findLineEnd(char const* begin, char const* end)
+{
+  auto lineEnd = static_cast<char const*>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+  return (lineEnd == nullptr) ? end : lineEnd;
+}
+
+inline char const* findNextLine(char const* begin, char const* end)
+{
+  auto lineEnd = findLineEnd(begin, end);
+  return (lineEnd == end) ? end : lineEnd + 1;
+}
+
+/*
+ * Counts the lines in the given range. A last line without a trailing line break is counted as well.
+ */
+size_t countLines(char const* begin, char const* end)
+{
+  size_t numberOfLines = 0;
+  for (auto it = begin; it < end; it = findNextLine(it, end)) {
+    ++numberOfLines;
+  }
+  return numberOfLines;
+}
+
+/*
+ * Splits the given range into (at most) the given number of ranges with roughly equal size. Each range starts at the beginning of a line.
+ */
+std::vector<LineRange> splitIntoLineAlignedRanges(char const* begin, char const* end, uint32_t numberOfRanges)
+{
+  auto size = static_cast<size_t>(end - begin);
+  numberOfRanges = static_cast<uint32_t>(std::clamp<size_t>(size / MINIMUM_BYTES_PER_THREAD, 1, std::max(numberOfRanges, 1u)));
+
+  std::vector<LineRange> ranges{};
+  auto rangeBegin = begin;
+  for (uint32_t i = 1; i <= numberOfRanges && rangeBegin < end; ++i) {
+    auto rangeEnd = (i == numberOfRanges) ? end : std::max(rangeBegin, begin + (size * i) / numberOfRanges);
+    if (rangeEnd < end && rangeEnd > begin && *(rangeEnd - 1) != '\n') {
+      rangeEnd = findNextLine(rangeEnd, end);
+    }
+    ranges.push_back(LineRange{rangeBegin, rangeEnd, 0, FIRST_DATA_LINE_NUMBER, 0, 0});
+    rangeBegin = rangeEnd;
+  }
+
+  return ranges;
+}
+
+/*
+ * Parses the next value of a line and advances the iterator behind it. Values can be separated by whitespaces and/or commas.
+ */
+inline bool parseValue(char const*& it, char const* lineEnd, TensorDataType& value)
+{
+  while (it < lineEnd && isSeparator(*it)) {
+    ++it;
+  }
+  if (it < lineEnd && *it == '+') { // std::from_chars does not accept an explicit plus sign
+    ++it;
+  }
+
+  auto [next, errorCode] = std::from_chars(it, lineEnd, value);
+  if (errorCode != std::errc() || (next < lineEnd && !isSeparator(*next))) {
+    return false;
+  }
+
+  it = next;
+  return true;
+}
+
+/*
+ * Parses all lines in the given range and writes the values row by row to the given (preallocated) buffers.
+ * Values after the expected number of columns are ignored.
+ */
+std::optional<ParseError> parseRows(char const* begin, char const* end, uint64_t firstLineNumber, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes,
+                                    TensorDataType* inputs, TensorDataType* outputs)
+{
+  auto lineNumber = firstLineNumber;
+  for (auto lineBegin = begin; lineBegin < end; ++lineNumber) {
+    auto lineEnd = findLineEnd(lineBegin, end);
+    auto it = lineBegin;
+
+    for (uint32_t i = 0; i < numberOfInputNodes; ++i) {
+      if (!parseValue(it, lineEnd, *inputs++)) {
+        return ParseError{lineNumber, false};
+      }
+    }
+
+    for (uint32_t i = 0; i < numberOfOutputNodes; ++i) {
+      if (!parseValue(it, lineEnd, *outputs++)) {
+        return ParseError{lineNumber, true};
+      }
+    }
+
+    lineBegin = (lineEnd == end) ? end : lineEnd + 1;
+  }
+
+  return std::nullopt;
+}
+
+/*
+ * Parses all lines in the given range in a single pass and appends the values row by row to the given vectors, which grow as needed.
+ * The number of parsed lines is added to the given counter. Values after the expected number of columns are ignored.
+ */
+std::optional<ParseError> appendRows(char const* begin, char const* end, uint64_t firstLineNumber, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes,
+                                     std::vector<TensorDataType>& inputs, std::vector<TensorDataType>& outputs, size_t& numberOfLines)
+{
+  auto lineNumber = firstLineNumber;
+  for (auto lineBegin = begin; lineBegin < end; ++lineNumber, ++numberOfLines) {
+    auto lineEnd = findLineEnd(lineBegin, end);
+    auto it = lineBegin;
+
+    inputs.resize(inputs.size() + numberOfInputNodes);
+    outputs.resize(outputs.size() + numberOfOutputNodes);
+    auto inputValues = inputs.data() + inputs.size() - numberOfInputNodes;
+    auto outputValues = outputs.data() + outputs.size() - numberOfOutputNodes;
+
+    for (uint32_t i = 0; i < numberOfInputNodes; ++i) {
+      if (!parseValue(it, lineEnd, inputValues[i])) {
+        return ParseError{lineNumber, false};
+      }
+    }
+
+    for (uint32_t i = 0; i < numberOfOutputNodes; ++i) {
+      if (!parseValue(it, lineEnd, outputValues[i])) {
+        return ParseError{lineNumber, true};
+      }
+    }
+
+    lineBegin = (lineEnd == end) ? end : lineEnd + 1;
+  }
+
+  return std::nullopt;
+}
+
+void printParseError(ParseError const& error, std::string const& filePath)
+{
+  std::cout << "Error: Unable to parse " << (error.inOutputPart ? "output" : "input") << " data in line " << error.lineNumber;
+  if (!filePath.empty()) {
+    std::cout << " of \"" << filePath << "\"";
+  }
+  std::cout << "." << std::endl;
+}
+
+/*
+ * Parses a compressed file while it is decompressed block by block on another thread.
+ * Lines which span two blocks are collected in a separate buffer. As the number of rows is unknown in advance, the values of each block are
+ * parsed in a single pass into separate vectors, which are concatenated once into the returned tensors at the end.
+ * The statistics of each block are added, while its values are still in the cache.
+ */
+std::optional<Dataset> parseCompressedFile(FilePath const& path, CompressedFileReader::Format format, uint32_t numberOfInputNodes, uint32_t numberOfOutputNodes,
+                                           std::string& fileHeader, DatasetStatistics& statistics)
+{
+  CompressedFileReader reader(path, format);
+
+  struct ParsedBlock
+  {
+    std::vector<TensorDataType> inputs;
+    std::vector<TensorDataType> outputs;
+  };
+  std::vector<ParsedBlock> parsedBlocks{};
+  size_t maximumRowsPerBlock = 0;
+  size_t numberOfRows = 0;
+  uint64_t lineNumber = 1;
+  bool headerRead = false;
+
+  // Handles complete lines (the last line may miss the line break):
+  auto processLines = [&](char const* begin, char const* end) -> std::optional<ParseError> {
+    if (!headerRead) {
+      fileHeader = std::string(begin, findLineEnd(begin, end));
+      headerRead = true;
+      ++lineNumber;
+      begin = findNextLine(begin, end);
+    }
+    if (begin >= end) {
+      return std::nullopt;
+    }
+
+    // The vectors of a block are reserved with the largest number of rows of the previous blocks (the blocks have the same size):
+    ParsedBlock parsedBlock{};
+    parsedBlock.inputs.reserve(maximumRowsPerBlock * numberOfInputNodes);
+    parsedBlock.outputs.reserve(maximumRowsPerBlock * numberOfOutputNodes);
+
+    size_t numberOfLines = 0;
+    auto error = appendRows(begin, end, lineNumber, numberOfInputNodes, numberOfOutputNodes, parsedBlock.inputs, parsedBlock.outputs, numberOfLines);
+    if (!error) {
+      statistics.inputs.addRows(parsedBlock.inputs.data(), static_cast<int64_t>(numberOfLines));
+      statistics.outputs.addRows(parsedBlock.outputs.data(), static_cast<int64_t>(numberOfLines));
+    }
+    maximumRowsPerBlock = std::max(maximumRowsPerBlock, numberOfLines);
+    numberOfRows += numberOfLines;
+    lineNumber += numberOfLines;
+    parsedBlocks.push_back(std::move(parsedBlock));
+    return error;
+  };
+
+  std::vector<char> block{};
+  std::string incompleteLine{};
+  std::optional<ParseError> error{};
+
+  while (!error && reader.readBlock(block)) {
+    char const* blockBegin = block.data();
+    char const* blockEnd = blockBegin + block.size();
+    auto lastLineBreak = static_cast<char const*>(::memrchr(blockBegin, '\n', block.size()));
+    if (lastLineBreak == nullptr) {
+      incompleteLine.append(blockBegin, blockEnd);
+      continue;
+    }
+
+    if (!incompleteLine.empty()) {
+      auto firstLineEnd = findNextLine(blockBegin, blockEnd);
+      incompleteLine.append(blockBegin, firstLineEnd);
+      error = processLines(incompleteLine.data(), incompleteLine.data() + incompleteLine.size());
+      incompleteLine.clear();
+      blockBegin = firstLineEnd;
+    }
+
+    if (!error && blockBegin <= lastLineBreak) {
+      error = processLines(blockBegin, lastLineBreak + 1);
+    }
+    incompleteLine.assign(lastLineBreak + 1, blockEnd);
+  }
+
+  if (auto decompressionError = reader.getError(); !decompressionError.empty()) {
+    std::cout << "Error: Unable to decompress \"" << path << "\": " << decompressionError << std::endl;
     return std::nullopt;
   }
 
-  std::ifstream inputFile(path);
+  if (!error && !incompleteLine.empty()) {
+    error = processLines(incompleteLine.data(), incompleteLine.data() + incompleteLine.size());
+  }
 
-  std::string line;
-  if (!std::getline(inputFile, line)) {
+  if (error) {
+    printParseError(*error, path);
+    return std::nullopt;
+  }
+  if (!headerRead) {
     std::cout << "Error: Inputfile is empty or not valid." << std::endl;
     return std::nullopt;
   }
-  fileHeader = line;
 
-  while (std::getline(inputFile, line)) {
-    line.erase (std::remove(line.begin(), line.end(), ','), line.end());  // remove ',' from string
-    std::istringstream iss(line);
-    TensorDataType value;
+  // The blocks are copied into the tensors and released one after another, so at most one block exists twice:
+  auto rows = static_cast<int64_t>(numberOfRows);
+  auto inputs = torch::empty({rows, numberOfInputNodes}, TORCH_DATA_TYPE);
+  auto outputs = torch::empty({rows, numberOfOutputNodes}, TORCH_DATA_TYPE);
+  auto inputValues = inputs.data_ptr<TensorDataType>();
+  auto outputValues = outputs.data_ptr<TensorDataType>();
+  for (auto& parsedBlock : parsedBlocks) {
+    inputValues = std::copy(parsedBlock.inputs.begin(), parsedBlock.inputs.end(), inputValues);
+    outputValues = std::copy(parsedBlock.outputs.begin(), parsedBlock.outputs.end(), outputValues);
+    parsedBlock = ParsedBlock{};
+  }
 
-    // get input:
-    auto inTensor = torch::zeros(numberOfInputNodes, TORCH_DATA_TYPE);
-    for (uint32_t i = 0; i < numberOfInputNodes; ++i) {
-      if (!(iss >> value)) {
-        std::cout << "Error: Unable to parse input data." << std::endl;
+  return std::make_optional(Dataset(inputs, outputs));
+}
+
+}
+
+std::optional<Dataset> FileParser::ParseInputFile(std::string const& path, uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes,
+                                                  std::string& fileHeader, uint32_t const numberOfThreads, DatasetStatistics* statistics)
+{
+  Dataset data(torch::empty({0, numberOfInputNodes}, TORCH_DATA_TYPE), torch::empty({0, numberOfOutputNodes}, TORCH_DATA_TYPE));
+  DatasetStatistics dataStatistics{ColumnStatistics(numberOfInputNodes), ColumnStatistics(numberOfOutputNodes)};
+  auto numberOfRows = ParseInputFileInChunks(path, numberOfInputNodes, numberOfOutputNodes, fileHeader, numberOfThreads, UNLIMITED_ROWS_PER_CHUNK,
+                                             [&data, &dataStatistics](Dataset const& chunk, DatasetStatistics const& chunkStatistics, uint64_t, uint64_t) {
+    data = chunk;
+    dataStatistics = chunkStatistics;
+    return true;
+  });
+  if (!numberOfRows) {
+    return std::nullopt;
+  }
+
+  if (statistics) {
+    *statistics = std::move(dataStatistics);
+  }
+
+  return std::make_optional(data);
+}
+
+std::optional<uint64_t> FileParser::ParseInputFileInChunks(std::string const& path, uint32_t const numberOfInputNodes, uint32_t const numberOfOutputNodes,
+                                                           std::string& fileHeader, uint32_t const numberOfThreads, uint64_t const maximumRowsPerChunk,
+                                                           ChunkFunction const& function)
+{
+  auto filePaths = GetInputFilePaths(path);
+  if (filePaths.empty()) {
+    std::cout << "Error: \"" << path << "\" is not a valid path to a file for the input data." << std::endl;
+    return std::nullopt;
+  }
+
+  std::vector<MappedFile> inputFiles{};
+  inputFiles.reserve(filePaths.size());
+  std::vector<LineRange> ranges{};
+
+  for (size_t i = 0; i < filePaths.size(); ++i) {
+    auto const& inputFile = inputFiles.emplace_back(filePaths[i]);
+    if (!inputFile.isOpen() || inputFile.size() == 0) {
+      if (filePaths.size() == 1) {
+        std::cout << "Error: Inputfile is empty or not valid." << std::endl;
+      } else {
+        std::cout << "Error: Inputfile \"" << filePaths[i] << "\" is empty or not valid." << std::endl;
+      }
+      return std::nullopt;
+    }
+
+    auto format = CompressedFileReader::DetectFormat(inputFile.data(), inputFile.size());
+    if (format != CompressedFileReader::Format::Uncompressed) {
+      if (filePaths.size() > 1) {
+        std::cout << "Error: \"" << filePaths[i] << "\" is compressed. Compressed files are only supported as single input file." << std::endl;
+        return std::nullopt;
+      }
+      if (!CompressedFileReader::IsSupported(format)) {
+        std::cout << "Error: \"" << filePaths[i] << "\" is compressed with " << CompressedFileReader::GetFormatName(format)
+                  << ", but the program was built without support for it." << std::endl;
+        return std::nullopt;
+      }
+      if (maximumRowsPerChunk != UNLIMITED_ROWS_PER_CHUNK) {
+        std::cout << "Error: \"" << filePaths[i] << "\" is compressed and cannot be read in chunks. Please decompress it first." << std::endl;
         return std::nullopt;
       }
-      inTensor[i] = value;
+
+      DatasetStatistics statistics{ColumnStatistics(numberOfInputNodes), ColumnStatistics(numberOfOutputNodes)};
+      auto data = parseCompressedFile(filePaths[i], format, numberOfInputNodes, numberOfOutputNodes, fileHeader, statistics);
+      if (!data) {
+        return std::nullopt;
+      }
+      auto numberOfRows = static_cast<uint64_t>(data->size());
+      if (numberOfRows > 0 && !function(*data, statistics, 0, numberOfRows)) {
+        return std::nullopt;
+      }
+      return std::make_optional(numberOfRows);
     }
 
-    // get output:
-    auto outTensor = torch::zeros(numberOfOutputNodes, TORCH_DATA_TYPE);
-    for (uint32_t i = 0; i < numberOfOutputNodes; ++i) {
-      if (!(iss >> value)) {
-        std::cout << "Error: Unable to parse output data." << std::endl;
+    char const* fileEnd = inputFile.data() + inputFile.size();
+    auto header = std::string(inputFile.data(), findLineEnd(inputFile.data(), fileEnd));
+    if (i == 0) {
+      fileHeader = header;
+    } else if (header != fileHeader) {
+      std::cout << "Error: The header of \"" << filePaths[i] << "\" differs from the header of \"" << filePaths[0] << "\"." << std::endl;
+      return std::nullopt;
+    }
+
+    // A single file is split into (at least) one range per thread, multiple files are parsed with (at least) one thread per file.
+    // Large files are split further, so that a chunk can be kept small:
+    auto dataBegin = findNextLine(inputFile.data(), fileEnd);
+    auto minimumNumberOfRanges = (filePaths.size() == 1) ? numberOfThreads : 1;
+    auto numberOfRanges = std::max<size_t>(minimumNumberOfRanges, static_cast<size_t>(fileEnd - dataBegin) / MAXIMUM_BYTES_PER_RANGE + 1);
+    auto fileRanges = splitIntoLineAlignedRanges(dataBegin, fileEnd, static_cast<uint32_t>(numberOfRanges));
+    for (auto& range : fileRanges) {
+      range.fileIndex = i;
+      ranges.push_back(range);
+    }
+  }
+
+  // Count the rows of each range first, so that every range knows its slot in the output buffers:
+  runInParallel(ranges.size(), numberOfThreads, [&ranges](size_t i) {
+    ranges[i].numberOfRows = countLines(ranges[i].begin, ranges[i].end);
+  });
+
+  uint64_t numberOfRows = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    bool firstRangeOfFile = (i == 0 || ranges[i - 1].fileIndex != ranges[i].fileIndex);
+    ranges[i].firstLineNumber = firstRangeOfFile ? FIRST_DATA_LINE_NUMBER : ranges[i - 1].firstLineNumber + ranges[i - 1].numberOfRows;
+    ranges[i].firstRow = numberOfRows;
+    numberOfRows += ranges[i].numberOfRows;
+  }
+
+  // Consecutive ranges are combined to chunks with at most the given number of rows (a chunk contains at least one range):
+  for (size_t firstRange = 0; firstRange < ranges.size();) {
+    auto lastRange = firstRange + 1;
+    auto numberOfChunkRows = ranges[firstRange].numberOfRows;
+    while (lastRange < ranges.size() && numberOfChunkRows + ranges[lastRange].numberOfRows <= maximumRowsPerChunk) {
+      numberOfChunkRows += ranges[lastRange++].numberOfRows;
+    }
+    auto firstChunkRow = ranges[firstRange].firstRow;
+
+    // Preallocate the contiguous buffers for all rows of the chunk:
+    auto inputs = torch::empty({static_cast<int64_t>(numberOfChunkRows), numberOfInputNodes}, TORCH_DATA_TYPE);
+    auto outputs = torch::empty({static_cast<int64_t>(numberOfChunkRows), numberOfOutputNodes}, TORCH_DATA_TYPE);
+    auto inputBuffer = inputs.data_ptr<TensorDataType>();
+    auto outputBuffer = outputs.data_ptr<TensorDataType>();
+
+    // The statistics of each range are collected by the thread which parses it, while the values are still in the cache:
+    std::vector<std::optional<ParseError>> errors(lastRange - firstRange);
+    std::vector<DatasetStatistics> rangeStatistics(errors.size(), DatasetStatistics{ColumnStatistics(numberOfInputNodes), ColumnStatistics(numberOfOutputNodes)});
+    runInParallel(errors.size(), numberOfThreads, [&](size_t i) {
+      auto const& range = ranges[firstRange + i];
+      auto row = range.firstRow - firstChunkRow;
+      errors[i] = parseRows(range.begin, range.end, range.firstLineNumber, numberOfInputNodes, numberOfOutputNodes,
+                            inputBuffer + row * numberOfInputNodes, outputBuffer + row * numberOfOutputNodes);
+      if (!errors[i]) {
+        rangeStatistics[i].inputs.addRows(inputBuffer + row * numberOfInputNodes, static_cast<int64_t>(range.numberOfRows));
+        rangeStatistics[i].outputs.addRows(outputBuffer + row * numberOfOutputNodes, static_cast<int64_t>(range.numberOfRows));
+      }
+    });
+
+    // Ranges are ordered, so the first error found is the one with the lowest line number:
+    for (size_t i = 0; i < errors.size(); ++i) {
+      if (errors[i]) {
+        printParseError(*errors[i], (filePaths.size() == 1) ? std::string() : filePaths[ranges[firstRange + i].fileIndex]);
         return std::nullopt;
       }
-      outTensor[i] = value;
     }
 
-    data.emplace_back(std::make_pair(inTensor, outTensor));
+    DatasetStatistics chunkStatistics{ColumnStatistics(numberOfInputNodes), ColumnStatistics(numberOfOutputNodes)};
+    for (auto const& statistics : rangeStatistics) {
+      chunkStatistics.merge(statistics);
+    }
+
+    if (numberOfChunkRows > 0 && !function(Dataset(inputs, outputs), chunkStatistics, firstChunkRow, numberOfRows)) {
+      return std::nullopt;
+    }
+    firstRange = lastRange;
   }
 
-  inputFile.close();
-  return std::make_optional(data);
+  return std::make_optional(numberOfRows);
 }
 
-void FileParser::SaveData(DataVector const& data, std::string const& outputFilePath, std::string const& fileHeader)
+std::vector<FilePath> FileParser::GetInputFilePaths(std::string const& path)
+{
+  std::vector<FilePath> filePaths{};
+  std::error_code errorCode{};
+
+  if (path.empty()) {
+    return filePaths;
+  }
+
+  if (std::filesystem::is_directory(path, errorCode)) {
+    for (auto const& entry : std::filesystem::directory_iterator(path, errorCode)) {
+      if (entry.is_regular_file(errorCode) && entry.path().filename().string().front() != '.') {
+        filePaths.push_back(entry.path().string());
+      }
+    }
+    std::sort(filePaths.begin(), filePaths.end());
+  } else if (path.find_first_of("*?[") != std::string::npos) {
+    glob_t globResult{};
+    if (::glob(path.c_str(), 0, nullptr, &globResult) == 0) { // the result is sorted by name
+      for (size_t i = 0; i < globResult.gl_pathc; ++i) {
+        if (std::filesystem::is_regular_file(globResult.gl_pathv[i], errorCode)) {
+          filePaths.emplace_back(globResult.gl_pathv[i]);
+        }
+      }
+    }
+    ::globfree(&globResult);
+  } else {
+    filePaths.push_back(path);
+  }
+
+  return filePaths;
+}
+
+void FileParser::SaveData(Dataset const& data, std::string const& outputFilePath, std::string const& fileHeader, bool const append)
 {
   if (data.empty()) {
     return;
   }
-  std::ofstream outputFile(outputFilePath);
+  std::ofstream outputFile(outputFilePath, append ? std::ios::app : std::ios::trunc);
+
+  if (!append) {
+    outputFile << fileHeader << "\n";
+  }
 
-  outputFile << fileHeader << "\n";
+  auto inputs = data.inputs().to(TORCH_DATA_TYPE).contiguous();
+  auto outputs = data.outputs().to(TORCH_DATA_TYPE).contiguous();
+  auto numberOfInputColumns = inputs.size(1);
+  auto numberOfOutputColumns = outputs.size(1);
+  auto inputValues = inputs.data_ptr<TensorDataType>();
+  auto outputValues = outputs.data_ptr<TensorDataType>();
 
-  for (auto const& [inputTensor, outputTensor] : data) {
-    outputFile << inputTensor[0].item<TensorDataType>();
+  for (size_t row = 0; row < data.size(); ++row) {
+    outputFile << *inputValues++;
 
-    for (int64_t i = 1; i < inputTensor.size(0); ++i) {
-      outputFile << ", " << inputTensor[i].item<TensorDataType>();
+    for (int64_t i = 1; i < numberOfInputColumns; ++i) {
+      outputFile << ", " << *inputValues++;
     }
 
-    for (int64_t i = 0; i < outputTensor.size(0); ++i) {
-      outputFile << ", " << outputTensor[i].item<TensorDataType>();
+    for (int64_t i = 0; i < numberOfOutputColumns; ++i) {
+      outputFile << ", " << *outputValues++;
     }
 
     outputFile << "\n";
@@ -0,0 +1,73 @@
+#include "Utilities/mappedfile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace Utilities {
+
+MappedFile::MappedFile(std::string const& path)
+{
+  int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    return;
+  }
+
+  struct stat fileStatus{};
+  if (::fstat(fileDescriptor, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode)) {
+    ::close(fileDescriptor);
+    return;
+  }
+
+  length = static_cast<size_t>(fileStatus.st_size);
+  if (length > 0) {
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fileDescriptor);
+      length = 0;
+      return;
+    }
+    ::madvise(mapping, length, MADV_SEQUENTIAL);
+    begin = static_cast<char const*>(mapping);
+  }
+
+  // The mapping stays valid after closing the file descriptor:
+  ::close(fileDescriptor);
+  opened = true;
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+  begin(std::exchange(other.begin, nullptr)), length(std::exchange(other.length, 0)), opened(std::exchange(other.opened, false))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if (this != &other) {
+    close();
+    begin = std::exchange(other.begin, nullptr);
+    length = std::exchange(other.length, 0);
+    opened = std::exchange(other.opened, false);
+  }
+  return *this;
+}
+
+void MappedFile::close()
+{
+  if (begin != nullptr) {
+    ::munmap(const_cast<char*>(begin), length);
+  }
+  begin = nullptr;
+  length = 0;
+  opened = false;
+}
+
+}
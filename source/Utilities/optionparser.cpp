@@ -375,6 +375,288 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
       case CLIParameters::DebugOutput:
         options.DebugOutput = true;
         break;
+      case CLIParameters::ConvertInput:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.ConvertInputFilePath = std::string(argv[++i]);
+        break;
+      case CLIParameters::CacheDirectory:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.CacheDirectory = std::string(argv[++i]);
+        break;
+      case CLIParameters::MemoryLimit:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.MemoryLimitInMB = std::make_optional(std::stoul(argv[++i]));
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::InputPipeline:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.InputPipelineFilePath = std::string(argv[++i]);
+        break;
+      case CLIParameters::OutputPipeline:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.OutputPipelineFilePath = std::string(argv[++i]);
+        break;
+      case CLIParameters::Precision:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        if (auto precision = PrecisionMap.find(argv[++i]); precision != PrecisionMap.end()) {
+          options.Precision = precision->second;
+        } else {
+          std::cout << "Unknown precision: " << std::string(argv[i]) << ". Possible values: float64, float32, bfloat16" << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::CompactStorage:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        if (auto format = CompactStorageFormatMap.find(argv[++i]); format != CompactStorageFormatMap.end()) {
+          options.CompactStorageFormat = format->second;
+        } else {
+          std::cout << "Unknown compact storage format: " << std::string(argv[i]) << ". Possible values: float16, fixed16" << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::Shuffle:
+        options.ShuffleData = true;
+        break;
+      case CLIParameters::BatchSize:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.BatchSize = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::Optimizer:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        if (auto optimizer = OptimizerTypeMap.find(argv[++i]); optimizer != OptimizerTypeMap.end()) {
+          options.Optimizer = optimizer->second;
+        } else {
+          std::cout << "Unknown optimizer: " << std::string(argv[i]) << ". Possible values: sgd, adam, adamw, rmsprop, lbfgs, lm" << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::Momentum:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.Momentum = std::stod(std::string(argv[++i]));
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::Nesterov:
+        options.Nesterov = true;
+        break;
+      case CLIParameters::WeightDecay:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.WeightDecay = std::stod(std::string(argv[++i]));
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LearnRateSchedule:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        if (auto schedule = LearnRateScheduleMap.find(argv[++i]); schedule != LearnRateScheduleMap.end()) {
+          options.LearnRateSchedule = schedule->second;
+        } else {
+          std::cout << "Unknown learning rate schedule: " << std::string(argv[i]) << ". Possible values: constant, step, cosine, onecycle, plateau" << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LearnRateStepEpochs:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.LearnRateStepEpochs = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::LearnRateFactor:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.LearnRateFactor = std::stod(std::string(argv[++i]));
+        } catch (std::exception const&) {
+          std::cout << "Could not parse " << std::string(argv[i]) << " to double." << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::EvaluationInterval:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.EvaluationInterval = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::EvaluationSampleSize:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.EvaluationSampleSize = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::ValidationInterval:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.ValidationInterval = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::ValidationPatience:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.ValidationPatience = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::Checkpoint:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.CheckpointFilePath = std::string(argv[++i]);
+        break;
+      case CLIParameters::CheckpointInterval:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.CheckpointInterval = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::Resume:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        options.ResumeFilePath = std::string(argv[++i]);
+        break;
+      case CLIParameters::DataParallelWorkers:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.DataParallelWorkers = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
+      case CLIParameters::HogwildThreads:
+        if (i + 1 >= argc) {
+          std::cout << "Not enough parameters after " << inputString << std::endl;
+          return std::nullopt;
+        }
+        try {
+          options.HogwildThreads = std::stoul(argv[++i]);
+        } catch (const std::invalid_argument& e) {
+          std::cout << "Could not convert " << std::string(argv[i]) << " to integer. Reason: " << e.what() << std::endl;
+          return std::nullopt;
+        } catch (const std::out_of_range& e) {
+          std::cout << std::string(argv[i]) << " is out of range. Error: " << e.what() << std::endl;
+          return std::nullopt;
+        }
+        break;
     }
   }
 
@@ -409,11 +691,93 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
     return std::nullopt;
   }
 
+  if (options.BatchSize == 0) {
+    std::cout << "Invalid batch size: 0. Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.DataParallelWorkers == 0) {
+    std::cout << "Invalid number of data parallel threads: 0. Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.HogwildThreads == 0) {
+    std::cout << "Invalid number of Hogwild threads: 0. Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
   if (options.LearnRate <= 0.0) {
     std::cout << "Invalid learning rate: " << options.LearnRate << ". Please input a number > 0." << std::endl;
     return std::nullopt;
   }
 
+  if (options.Momentum < 0.0 || options.Momentum >= 1.0) {
+    std::cout << "Invalid momentum: " << options.Momentum << ". Please input a number in [0, 1)." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.Nesterov && (options.Optimizer != OptimizerType::SGD || options.Momentum == 0.0)) {
+    std::cout << "Nesterov momentum (--nesterov) needs the optimizer sgd and a momentum > 0 (--momentum)." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.WeightDecay < 0.0) {
+    std::cout << "Invalid weight decay: " << options.WeightDecay << ". Please input a number >= 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.LearnRateStepEpochs == 0) {
+    std::cout << "Invalid number of epochs per learning rate step: 0. Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.LearnRateFactor <= 0.0 || options.LearnRateFactor > 1.0) {
+    std::cout << "Invalid learning rate factor: " << options.LearnRateFactor << ". Please input a number in (0, 1]." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.MemoryLimitInMB.has_value() && options.MemoryLimitInMB.value() == 0) {
+    std::cout << "Invalid memory limit: 0. Please input a number > 0." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.MemoryLimitInMB.has_value() && options.BatchVariable.has_value()) {
+    std::cout << "Batch training (--batchVariable) needs all training data in memory and cannot be used together with --memoryLimit." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.CompactStorageFormat.has_value() && options.BatchVariable.has_value()) {
+    std::cout << "Batch training (--batchVariable) needs the training data as dataset and cannot be used together with --compactStorage." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.ValidationInterval > 0 && !options.ValidateAfterTraining) {
+    std::cout << "The validation during the training (--validateEvery) needs validation data. Please activate the validation with --validate." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.ValidationInterval > 0 && options.MemoryLimitInMB.has_value()) {
+    std::cout << "The validation during the training (--validateEvery) cannot be used together with --memoryLimit, because the data is streamed from one file." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.InputPipelineFilePath != DefaultValues::INPUT_PIPELINE_FILE_PATH && options.InputMinMaxFilePath != DefaultValues::INPUT_MIN_MAX_FILE_PATH) {
+    std::cout << "The min/max values are part of the transform pipeline. Please use either --inPipeline or --inMinMax." << std::endl;
+    return std::nullopt;
+  }
+
+  if ((options.CheckpointInterval > 0) != (options.CheckpointFilePath != DefaultValues::CHECKPOINT_FILE_PATH)) {
+    std::cout << "Checkpoints need both the file (--checkpoint) and the number of epochs between them (--checkpointEvery)." << std::endl;
+    return std::nullopt;
+  }
+
+  if (options.ResumeFilePath != DefaultValues::RESUME_FILE_PATH &&
+      (options.InputNetworkParameters != DefaultValues::INPUT_NETWORK_PARAMETERS || options.InputPipelineFilePath != DefaultValues::INPUT_PIPELINE_FILE_PATH ||
+       options.InputMinMaxFilePath != DefaultValues::INPUT_MIN_MAX_FILE_PATH)) {
+    std::cout << "The checkpoint (--resume) contains the weights and the transform pipeline. Please do not use --inWeights, --inPipeline or --inMinMax together with it." << std::endl;
+    return std::nullopt;
+  }
+
   // Warnings:
   if (validationPercentageSet && !options.ValidateAfterTraining) {
     std::cout << "[Warning] A validation percentage was set, but the validation mode is not active! Activate validation with --validate" << std::endl;
@@ -421,12 +785,79 @@ std::optional<ProgramOptions> OptionParser::ParseCommandLineParameters(int argc,
 
   if (!options.InteractiveMode && !options.PrintBehaviour && options.OutputDiffFilePath == DefaultValues::OUTPUT_DIFF &&
       options.OutputRelativeDiffFilePath == DefaultValues::OUTPUT_RELATIVE_DIFF && options.OutputMinMaxFilePath == DefaultValues::OUTPUT_MIN_MAX_FILE_PATH &&
-      options.OutputNetworkParameters == DefaultValues::OUTPUT_NETWORK_PARAMETERS && options.OutputValuesFilePath == DefaultValues::OUTPUT_VALUE) {
+      options.OutputPipelineFilePath == DefaultValues::OUTPUT_PIPELINE_FILE_PATH &&
+      options.OutputNetworkParameters == DefaultValues::OUTPUT_NETWORK_PARAMETERS && options.OutputValuesFilePath == DefaultValues::OUTPUT_VALUE &&
+      options.ConvertInputFilePath == DefaultValues::CONVERT_INPUT_FILE_PATH && options.CheckpointFilePath == DefaultValues::CHECKPOINT_FILE_PATH) {
     std::cout << "[Warning] No option was set to output something. For available commands try --help" << std::endl;
   }
 
-  if (options.MaxExecutionTime > std::chrono::hours(24 * 7)) {
-    std::cout << "[Warning] The timeout is set to a very long time (> 1 week). If the execution is interrupted, all progress is lost." << std::endl;
+  if (options.MaxExecutionTime > std::chrono::hours(24 * 7) && options.CheckpointInterval == 0) {
+    std::cout << "[Warning] The timeout is set to a very long time (> 1 week). If the execution is interrupted, all progress is lost (see --checkpointEvery)." << std::endl;
+  }
+
+  if (options.MemoryLimitInMB.has_value() && options.CacheDirectory != DefaultValues::CACHE_DIRECTORY) {
+    std::cout << "[Warning] The cache directory is ignored, because the data is streamed from disk with --memoryLimit." << std::endl;
+  }
+
+  if (options.ResumeFilePath != DefaultValues::RESUME_FILE_PATH && options.CacheDirectory != DefaultValues::CACHE_DIRECTORY) {
+    std::cout << "[Warning] The cache directory is ignored, because the data is normalized with the transform pipeline of the checkpoint (--resume)." << std::endl;
+  }
+
+  if (options.BatchSize != DefaultValues::BATCH_SIZE && options.BatchVariable.has_value()) {
+    std::cout << "[Warning] The batch size is ignored, because the training data is concatenated to batches around the batch variable (--batchVariable)." << std::endl;
+  }
+
+  if (options.ShuffleData && options.BatchVariable.has_value()) {
+    std::cout << "[Warning] The training data is not shuffled, because it is concatenated to batches around the batch variable (--batchVariable)." << std::endl;
+  }
+
+  if (options.Momentum != DefaultValues::MOMENTUM && options.Optimizer != OptimizerType::SGD && options.Optimizer != OptimizerType::RMSprop) {
+    std::cout << "[Warning] The momentum is ignored, because it is only used by the optimizers sgd and rmsprop." << std::endl;
+  }
+
+  bool usesFullBatch = options.Optimizer == OptimizerType::LBFGS || options.Optimizer == OptimizerType::LevenbergMarquardt;
+  if (usesFullBatch && (options.BatchVariable.has_value() || options.BatchSize != DefaultValues::BATCH_SIZE || options.ShuffleData)) {
+    std::cout << "[Warning] The batch options (--batchVariable, --batchSize, --shuffle) are ignored, because the optimizer uses all training data in each step." << std::endl;
+  }
+
+  if (options.DataParallelWorkers > 1 &&
+      (usesFullBatch || (!options.BatchVariable.has_value() && options.BatchSize <= 1))) {
+    std::cout << "[Warning] The data parallel training (--dataParallel) is only used for batches of several rows (--batchSize > 1 or --batchVariable, " <<
+                 "--shuffle alone is not enough) of the optimizers sgd, adam, adamw and rmsprop." << std::endl;
+  }
+
+  if (options.DataParallelWorkers > 1 && options.NumberOfThreads > 1) {
+    std::cout << "[Warning] Each of the " << options.DataParallelWorkers << " data parallel threads uses " << options.NumberOfThreads <<
+                 " threads for its computations, which may oversubscribe the cores. Consider setting --threads 1." << std::endl;
+  }
+
+  if (options.HogwildThreads > 1 &&
+      (usesFullBatch || options.BatchVariable.has_value() || options.BatchSize != DefaultValues::BATCH_SIZE || options.ShuffleData)) {
+    std::cout << "[Warning] The Hogwild training (--hogwild) is only used for the training row by row (--batchSize 1 without --shuffle and --batchVariable) " <<
+                 "of the optimizers sgd, adam, adamw and rmsprop." << std::endl;
+  }
+
+  if (options.HogwildThreads > 1 && options.NumberOfThreads > 1) {
+    std::cout << "[Warning] Each of the " << options.HogwildThreads << " Hogwild threads uses " << options.NumberOfThreads <<
+                 " threads for its computations, which may oversubscribe the cores. Consider setting --threads 1." << std::endl;
+  }
+
+  if (options.HogwildThreads > 1 && options.CheckpointInterval > 0) {
+    std::cout << "[Warning] The optimizer states of the Hogwild threads are not part of the checkpoints, a resumed training starts them anew." << std::endl;
+  }
+
+  if (usesFullBatch && options.WeightDecay != DefaultValues::WEIGHT_DECAY) {
+    std::cout << "[Warning] The weight decay is ignored by the optimizers lbfgs and lm." << std::endl;
+  }
+
+  if (options.Optimizer == OptimizerType::LevenbergMarquardt &&
+      (options.LearnRate != DefaultValues::LEARN_RATE || options.LearnRateSchedule != DefaultValues::LEARN_RATE_SCHEDULE)) {
+    std::cout << "[Warning] The learning rate and its schedule are ignored, because the optimizer lm adapts its damping factor instead." << std::endl;
+  }
+
+  if (options.LearnRateSchedule == LearnRateScheduleType::ReduceOnPlateau && options.Epsilon == DefaultValues::EPSILON) {
+    std::cout << "[Warning] The plateau schedule reduces the learning rate, if the error does not improve by at least epsilon. " <<
+                 "Consider setting an epsilon (--epsilon) which fits to your data." << std::endl;
   }
 
   if (options.Epsilon < 0.0) {
@@ -0,0 +1,547 @@
+#include "Utilities/parallel.h"
+#include "Utilities/transformpipeline.h"
+
+#include <iostream>
+
+namespace Utilities {
+
+namespace {
+
+const int64_t PIPELINE_FORMAT_VERSION = 1;
+const TensorDataType MINIMUM_ALLOWED_VALUE = 1e-30; // values are raised to it before the logarithmic or square root scaling
+const int64_t ROWS_PER_TASK = 1 << 14;
+const int64_t ROWS_PER_BLOCK = 256; // the region mask of a mixed scaling is calculated for a block of rows at once (ROWS_PER_TASK is a multiple of it)
+
+/*
+ * Row-major buffer of a matrix [N, C] or of a single row [C]. A contiguous matrix of TORCH_DATA_TYPE is changed in place.
+ * If the matrix is not contiguous or has another data type, the buffer is a copy, which has to be written back after it was changed.
+ * An undefined matrix results in an empty buffer.
+ */
+class RowBuffer
+{
+public:
+  explicit RowBuffer(torch::Tensor const& matrix_) :
+    matrix(matrix_), buffer(matrix_.defined() ? matrix_.to(TORCH_DATA_TYPE).contiguous() : matrix_),
+    numberOfColumns(matrix_.defined() && matrix_.dim() > 0 ? matrix_.size(-1) : 0),
+    values(numberOfColumns > 0 && buffer.numel() > 0 ? buffer.data_ptr<TensorDataType>() : nullptr)
+  {
+  }
+
+  [[nodiscard]]
+  int64_t getNumberOfRows() const { return numberOfColumns > 0 ? buffer.numel() / numberOfColumns : 0; }
+  [[nodiscard]]
+  int64_t getNumberOfColumns() const { return numberOfColumns; }
+  [[nodiscard]]
+  TensorDataType* row(int64_t row) const { return values + row * numberOfColumns; }
+
+  void writeBack()
+  {
+    if (buffer.defined() && !buffer.is_same(matrix)) {
+      matrix.copy_(buffer);
+    }
+  }
+
+private:
+  torch::Tensor matrix;
+  torch::Tensor buffer;
+  int64_t numberOfColumns;
+  TensorDataType* values;
+};
+
+/*
+ * Calls the given function for each row index in [0, numberOfRows). The rows are split across the given number of threads.
+ */
+template<class Function>
+void forEachRow(int64_t numberOfRows, uint32_t numberOfThreads, Function const& function)
+{
+  auto numberOfTasks = static_cast<size_t>((numberOfRows + ROWS_PER_TASK - 1) / ROWS_PER_TASK);
+  runInParallel(numberOfTasks, numberOfThreads, [numberOfRows, &function](size_t task) {
+    auto firstRow = static_cast<int64_t>(task) * ROWS_PER_TASK;
+    auto lastRow = std::min(firstRow + ROWS_PER_TASK, numberOfRows);
+    for (auto row = firstRow; row < lastRow; ++row) {
+      function(row);
+    }
+  });
+}
+
+/*
+ * Calls the given function for each block [firstRow, lastRow) of at most ROWS_PER_BLOCK rows. The blocks are split across the given number of threads.
+ */
+template<class Function>
+void forEachBlock(int64_t numberOfRows, uint32_t numberOfThreads, Function const& function)
+{
+  auto numberOfTasks = static_cast<size_t>((numberOfRows + ROWS_PER_TASK - 1) / ROWS_PER_TASK);
+  runInParallel(numberOfTasks, numberOfThreads, [numberOfRows, &function](size_t task) {
+    auto lastRowOfTask = std::min(static_cast<int64_t>(task + 1) * ROWS_PER_TASK, numberOfRows);
+    for (auto firstRow = static_cast<int64_t>(task) * ROWS_PER_TASK; firstRow < lastRowOfTask; firstRow += ROWS_PER_BLOCK) {
+      function(firstRow, std::min(firstRow + ROWS_PER_BLOCK, lastRowOfTask));
+    }
+  });
+}
+
+/*
+ * Writes the region of a mixed scaling of each row in [firstRow, lastRow) to the mask: 1 if the threshold variable is above the threshold, 0 otherwise.
+ */
+void calculateRegionMask(RowBuffer const& inputRows, int64_t firstRow, int64_t lastRow, uint32_t thresholdVariable, TensorDataType threshold, uint8_t* mask)
+{
+  auto stride = inputRows.getNumberOfColumns();
+  auto thresholdValues = inputRows.row(firstRow) + thresholdVariable;
+  for (int64_t i = 0; i < lastRow - firstRow; ++i) {
+    mask[i] = static_cast<uint8_t>(!(thresholdValues[i * stride] <= threshold));
+  }
+}
+
+/*
+ * Calls the given function with the function which scales (or unscales, if inverse is true) a single value.
+ * The scaling is decided once per call, so the loops of the given function do not contain any branches.
+ */
+template<class Function>
+inline void withScalingFunction(TransformPipeline::Scaling scaling, bool inverse, Function const& function)
+{
+  switch (scaling) {
+    case TransformPipeline::Scaling::Logarithmic:
+      if (inverse) {
+        function([](TensorDataType value) { return std::exp(value); });
+      } else {
+        function([](TensorDataType value) { return std::log(std::max(value, MINIMUM_ALLOWED_VALUE)); });
+      }
+      break;
+    case TransformPipeline::Scaling::SquareRoot:
+      if (inverse) {
+        function([](TensorDataType value) { return value * value; });
+      } else {
+        function([](TensorDataType value) { return std::sqrt(std::max(value, MINIMUM_ALLOWED_VALUE)); });
+      }
+      break;
+    case TransformPipeline::Scaling::None:
+      function([](TensorDataType value) { return value; });
+      break;
+  }
+}
+
+torch::Tensor toTensor(MinMaxVector const& minMaxVector)
+{
+  auto tensor = torch::empty({static_cast<int64_t>(minMaxVector.size()), 2}, TORCH_DATA_TYPE);
+  auto values = tensor.data_ptr<TensorDataType>();
+  for (auto const& [min, max] : minMaxVector) {
+    *values++ = min;
+    *values++ = max;
+  }
+  return tensor;
+}
+
+MinMaxVector toMinMaxVector(torch::Tensor const& tensor)
+{
+  auto contiguousTensor = tensor.to(TORCH_DATA_TYPE).contiguous();
+  auto values = contiguousTensor.data_ptr<TensorDataType>();
+  MinMaxVector minMaxVector{};
+  for (int64_t i = 0; i < contiguousTensor.size(0); ++i) {
+    minMaxVector.emplace_back(values[2 * i], values[2 * i + 1]);
+  }
+  return minMaxVector;
+}
+
+torch::Tensor toTensor(std::vector<TensorDataType> const& values)
+{
+  return torch::tensor(values, TORCH_DATA_TYPE);
+}
+
+std::vector<TensorDataType> toVector(torch::Tensor const& tensor)
+{
+  auto contiguousTensor = tensor.to(TORCH_DATA_TYPE).contiguous();
+  auto values = contiguousTensor.data_ptr<TensorDataType>();
+  return std::vector<TensorDataType>(values, values + contiguousTensor.numel());
+}
+
+}
+
+TransformPipeline::TransformPipeline(ProgramOptions const& options) :
+  numberOfInputVariables(options.NumberOfInputVariables), numberOfOutputVariables(options.NumberOfOutputVariables),
+  mixedScaling(options.LogLinScaling || options.LogSqrtScaling), thresholdVariable(options.MixedScalingInputVariable),
+  threshold(options.MixedScalingThreshold), normalizedThreshold(options.MixedScalingThreshold)
+{
+  if (options.LogScaling || options.LogLinScaling || options.LogSqrtScaling) {
+    outputScaling[0] = Scaling::Logarithmic;
+  } else if (options.SqrtScaling) {
+    outputScaling[0] = Scaling::SquareRoot;
+  }
+  outputScaling[1] = mixedScaling ? (options.LogSqrtScaling ? Scaling::SquareRoot : Scaling::None) : outputScaling[0];
+
+  auto createIdentity = [](uint32_t numberOfColumns) {
+    return AffineTransform{std::vector<TensorDataType>(numberOfColumns, 1.0), std::vector<TensorDataType>(numberOfColumns, 0.0)};
+  };
+  inputNormalization = createIdentity(numberOfInputVariables);
+  inputDenormalization = createIdentity(numberOfInputVariables);
+  for (size_t region = 0; region < NUMBER_OF_REGIONS; ++region) {
+    outputNormalization[region] = createIdentity(numberOfOutputVariables);
+    outputDenormalization[region] = createIdentity(numberOfOutputVariables);
+  }
+}
+
+void TransformPipeline::setMinMax(MinMaxValues const& minMax_)
+{
+  minMax = minMax_;
+  setNormalization(minMax.first, {&minMax.second, &minMax.second});
+}
+
+void TransformPipeline::setMixedMinMax(MixedMinMaxValues const& mixedMinMax_)
+{
+  mixedMinMax = mixedMinMax_;
+  setNormalization(mixedMinMax.first.first, {&mixedMinMax.first.second, &mixedMinMax.second.second});
+}
+
+void TransformPipeline::setNormalization(MinMaxVector const& inputMinMax, std::array<MinMaxVector const*, NUMBER_OF_REGIONS> const& outputMinMax)
+{
+  // Normalize data -- '(X - min) / (max - min)' scaled to [newMin, newMax] equals 'X * scale + offset':
+  auto createTransforms = [](MinMaxVector const& minMaxVector, std::pair<TensorDataType, TensorDataType> const& range,
+                             AffineTransform& normalizationTransform, AffineTransform& denormalizationTransform) {
+    auto const& [newMin, newMax] = range;
+    normalizationTransform = AffineTransform{};
+    denormalizationTransform = AffineTransform{};
+    for (auto const& [min, max] : minMaxVector) {
+      auto scale = (newMax - newMin) / (max - min);
+      normalizationTransform.scale.push_back(scale);
+      normalizationTransform.offset.push_back(newMin - min * scale);
+      denormalizationTransform.scale.push_back(1.0 / scale);
+      denormalizationTransform.offset.push_back(min - newMin / scale);
+    }
+  };
+
+  createTransforms(inputMinMax, {0.0, 1.0}, inputNormalization, inputDenormalization);
+  normalizedOutputRange[0] = mixedScaling ? std::make_pair(-1.0, 0.0) : std::make_pair(0.0, 1.0);
+  normalizedOutputRange[1] = std::make_pair(0.0, 1.0);
+  for (size_t region = 0; region < NUMBER_OF_REGIONS; ++region) {
+    createTransforms(*outputMinMax[region], normalizedOutputRange[region], outputNormalization[region], outputDenormalization[region]);
+  }
+
+  normalizedThreshold = threshold;
+  if (mixedScaling && thresholdVariable < inputNormalization.scale.size()) {
+    normalizedThreshold = threshold * inputNormalization.scale[thresholdVariable] + inputNormalization.offset[thresholdVariable];
+  }
+}
+
+bool TransformPipeline::usesMixedScaling() const
+{
+  return mixedScaling;
+}
+
+bool TransformPipeline::matchesOptions(ProgramOptions const& options) const
+{
+  TransformPipeline other(options);
+  return numberOfInputVariables == other.numberOfInputVariables && numberOfOutputVariables == other.numberOfOutputVariables &&
+         mixedScaling == other.mixedScaling && outputScaling == other.outputScaling &&
+         (!mixedScaling || (thresholdVariable == other.thresholdVariable && threshold == other.threshold));
+}
+
+MinMaxValues const& TransformPipeline::getMinMax() const
+{
+  return minMax;
+}
+
+MixedMinMaxValues const& TransformPipeline::getMixedMinMax() const
+{
+  return mixedMinMax;
+}
+
+TensorDataType TransformPipeline::getNormalizedThreshold() const
+{
+  return normalizedThreshold;
+}
+
+MinMaxValues TransformPipeline::getNormalizedValueRanges() const
+{
+  auto outputRange = std::make_pair(std::min(normalizedOutputRange[0].first, normalizedOutputRange[1].first),
+                                    std::max(normalizedOutputRange[0].second, normalizedOutputRange[1].second));
+  return std::make_pair(MinMaxVector(numberOfInputVariables, std::make_pair(0.0, 1.0)), MinMaxVector(numberOfOutputVariables, outputRange));
+}
+
+void TransformPipeline::scale(Dataset& data, uint32_t const numberOfThreads) const
+{
+  transform(data, true, false, numberOfThreads);
+}
+
+void TransformPipeline::normalize(Dataset& data, uint32_t const numberOfThreads) const
+{
+  transform(data, false, true, numberOfThreads);
+}
+
+void TransformPipeline::forward(Dataset& data, uint32_t const numberOfThreads) const
+{
+  transform(data, true, true, numberOfThreads);
+}
+
+void TransformPipeline::transform(Dataset& data, bool const scaleOutputs, bool const normalizeValues, uint32_t const numberOfThreads) const
+{
+  if (data.empty() || data.getNumberOfInputVariables() != static_cast<int64_t>(inputNormalization.scale.size()) ||
+      data.getNumberOfOutputVariables() != static_cast<int64_t>(outputNormalization[0].scale.size())) {
+    return;
+  }
+
+  // Scaling without any scaling function would not change the data:
+  bool hasScaling = outputScaling[0] != Scaling::None || (mixedScaling && outputScaling[1] != Scaling::None);
+  if (!normalizeValues && (!scaleOutputs || !hasScaling)) {
+    return;
+  }
+
+  // The inputs are only needed for the normalization and for the regions of a mixed scaling:
+  auto inputs = (normalizeValues || mixedScaling) ? data.inputs() : torch::Tensor();
+  auto outputs = data.outputs();
+  RowBuffer inputRows(inputs);
+  RowBuffer outputRows(outputs);
+  auto numberOfInputs = inputRows.getNumberOfColumns();
+  auto numberOfOutputs = outputRows.getNumberOfColumns();
+
+  // Without normalization, the affine step of the outputs is the identity:
+  AffineTransform identity{std::vector<TensorDataType>(static_cast<size_t>(numberOfOutputs), 1.0),
+                           std::vector<TensorDataType>(static_cast<size_t>(numberOfOutputs), 0.0)};
+  auto const& normalization0 = normalizeValues ? outputNormalization[0] : identity;
+  auto const& normalization1 = normalizeValues ? outputNormalization[1] : identity;
+  auto scale0 = normalization0.scale.data(), offset0 = normalization0.offset.data();
+  auto scale1 = normalization1.scale.data(), offset1 = normalization1.offset.data();
+
+  withScalingFunction(scaleOutputs ? outputScaling[0] : Scaling::None, false, [&](auto const& scaleValue0) {
+    withScalingFunction(scaleOutputs ? outputScaling[1] : Scaling::None, false, [&](auto const& scaleValue1) {
+      forEachBlock(static_cast<int64_t>(data.size()), numberOfThreads, [&](int64_t firstRow, int64_t lastRow) {
+        // The region of a mixed scaling is decided with the unnormalized threshold variable, so the mask is calculated before the inputs are normalized.
+        // Both regions are evaluated for each value and the result is selected with the mask, so the loops do not branch on the data:
+        std::array<uint8_t, ROWS_PER_BLOCK> regionMask{};
+        if (mixedScaling) {
+          calculateRegionMask(inputRows, firstRow, lastRow, thresholdVariable, threshold, regionMask.data());
+        }
+
+        for (auto row = firstRow; row < lastRow; ++row) {
+          auto outputValues = outputRows.row(row);
+          if (mixedScaling) {
+            bool aboveThreshold = regionMask[static_cast<size_t>(row - firstRow)] != 0;
+            for (int64_t i = 0; i < numberOfOutputs; ++i) {
+              auto value0 = scaleValue0(outputValues[i]) * scale0[i] + offset0[i];
+              auto value1 = scaleValue1(outputValues[i]) * scale1[i] + offset1[i];
+              outputValues[i] = aboveThreshold ? value1 : value0;
+            }
+          } else {
+            for (int64_t i = 0; i < numberOfOutputs; ++i) {
+              outputValues[i] = scaleValue0(outputValues[i]) * scale0[i] + offset0[i];
+            }
+          }
+        }
+
+        if (normalizeValues) {
+          auto inputScale = inputNormalization.scale.data();
+          auto inputOffset = inputNormalization.offset.data();
+          for (auto row = firstRow; row < lastRow; ++row) {
+            auto inputValues = inputRows.row(row);
+            for (int64_t i = 0; i < numberOfInputs; ++i) {
+              inputValues[i] = inputValues[i] * inputScale[i] + inputOffset[i];
+            }
+          }
+        }
+      });
+    });
+  });
+
+  outputRows.writeBack();
+  data.setOutputs(outputs);
+  if (normalizeValues) {
+    inputRows.writeBack();
+    data.setInputs(inputs);
+  }
+}
+
+void TransformPipeline::normalizeInputs(torch::Tensor& inputs, uint32_t const numberOfThreads) const
+{
+  RowBuffer inputRows(inputs);
+  if (inputRows.getNumberOfColumns() != static_cast<int64_t>(inputNormalization.scale.size())) {
+    return;
+  }
+
+  auto numberOfInputs = inputRows.getNumberOfColumns();
+  forEachRow(inputRows.getNumberOfRows(), numberOfThreads, [&](int64_t row) {
+    auto values = inputRows.row(row);
+    for (int64_t i = 0; i < numberOfInputs; ++i) {
+      values[i] = values[i] * inputNormalization.scale[i] + inputNormalization.offset[i];
+    }
+  });
+  inputRows.writeBack();
+}
+
+void TransformPipeline::denormalizeInputs(torch::Tensor& inputs, bool const limitValues, uint32_t const numberOfThreads) const
+{
+  RowBuffer inputRows(inputs);
+  if (inputRows.getNumberOfColumns() != static_cast<int64_t>(inputDenormalization.scale.size())) {
+    return;
+  }
+
+  auto numberOfInputs = inputRows.getNumberOfColumns();
+  forEachRow(inputRows.getNumberOfRows(), numberOfThreads, [&](int64_t row) {
+    auto values = inputRows.row(row);
+    for (int64_t i = 0; i < numberOfInputs; ++i) {
+      auto value = limitValues ? std::max(0.0, std::min(1.0, values[i])) : values[i];
+      values[i] = value * inputDenormalization.scale[i] + inputDenormalization.offset[i];
+    }
+  });
+  inputRows.writeBack();
+}
+
+void TransformPipeline::inverseOutputs(torch::Tensor const& normalizedInputs, torch::Tensor& outputs, bool const limitValues, uint32_t const numberOfThreads) const
+{
+  RowBuffer inputRows(normalizedInputs);
+  RowBuffer outputRows(outputs);
+  if (outputRows.getNumberOfColumns() != static_cast<int64_t>(outputDenormalization[0].scale.size()) ||
+      (mixedScaling && inputRows.getNumberOfRows() != outputRows.getNumberOfRows())) {
+    return;
+  }
+
+  auto numberOfOutputs = outputRows.getNumberOfColumns();
+  auto scale0 = outputDenormalization[0].scale.data(), offset0 = outputDenormalization[0].offset.data();
+  auto scale1 = outputDenormalization[1].scale.data(), offset1 = outputDenormalization[1].offset.data();
+  auto const& [lowerLimit0, upperLimit0] = normalizedOutputRange[0];
+  auto const& [lowerLimit1, upperLimit1] = normalizedOutputRange[1];
+
+  withScalingFunction(outputScaling[0], true, [&](auto const& unscaleValue0) {
+    withScalingFunction(outputScaling[1], true, [&](auto const& unscaleValue1) {
+      forEachBlock(outputRows.getNumberOfRows(), numberOfThreads, [&](int64_t firstRow, int64_t lastRow) {
+        // The inputs are already normalized, so the region of a mixed scaling is decided with the normalized threshold:
+        std::array<uint8_t, ROWS_PER_BLOCK> regionMask{};
+        if (mixedScaling) {
+          calculateRegionMask(inputRows, firstRow, lastRow, thresholdVariable, normalizedThreshold, regionMask.data());
+        }
+
+        for (auto row = firstRow; row < lastRow; ++row) {
+          auto values = outputRows.row(row);
+          if (mixedScaling) {
+            bool aboveThreshold = regionMask[static_cast<size_t>(row - firstRow)] != 0;
+            for (int64_t i = 0; i < numberOfOutputs; ++i) {
+              auto value0 = limitValues ? std::max(lowerLimit0, std::min(upperLimit0, values[i])) : values[i];
+              auto value1 = limitValues ? std::max(lowerLimit1, std::min(upperLimit1, values[i])) : values[i];
+              value0 = unscaleValue0(value0 * scale0[i] + offset0[i]);
+              value1 = unscaleValue1(value1 * scale1[i] + offset1[i]);
+              values[i] = aboveThreshold ? value1 : value0;
+            }
+          } else {
+            for (int64_t i = 0; i < numberOfOutputs; ++i) {
+              auto value = limitValues ? std::max(lowerLimit0, std::min(upperLimit0, values[i])) : values[i];
+              values[i] = unscaleValue0(value * scale0[i] + offset0[i]);
+            }
+          }
+        }
+      });
+    });
+  });
+  outputRows.writeBack();
+}
+
+void TransformPipeline::write(torch::serialize::OutputArchive& archive) const
+{
+  archive.write("version", torch::tensor(std::vector<int64_t>{PIPELINE_FORMAT_VERSION}, torch::kInt64));
+  archive.write("configuration", torch::tensor(std::vector<int64_t>{numberOfInputVariables, numberOfOutputVariables, mixedScaling, thresholdVariable,
+                                                                    static_cast<int64_t>(outputScaling[0]), static_cast<int64_t>(outputScaling[1])}, torch::kInt64));
+  archive.write("thresholds", toTensor(std::vector<TensorDataType>{threshold, normalizedThreshold}));
+
+  auto const& [mixedMinMax1, mixedMinMax2] = mixedMinMax;
+  std::vector<MinMaxVector const*> minMaxVectors{&minMax.first, &minMax.second, &mixedMinMax1.first, &mixedMinMax1.second,
+                                                 &mixedMinMax2.first, &mixedMinMax2.second};
+  for (size_t i = 0; i < minMaxVectors.size(); ++i) {
+    archive.write("minMax" + std::to_string(i), toTensor(*minMaxVectors[i]));
+  }
+
+  auto writeTransform = [&archive](std::string const& name, AffineTransform const& transform) {
+    archive.write(name + "Scale", toTensor(transform.scale));
+    archive.write(name + "Offset", toTensor(transform.offset));
+  };
+  writeTransform("inputNormalization", inputNormalization);
+  writeTransform("inputDenormalization", inputDenormalization);
+  for (size_t region = 0; region < NUMBER_OF_REGIONS; ++region) {
+    writeTransform("outputNormalization" + std::to_string(region), outputNormalization[region]);
+    writeTransform("outputDenormalization" + std::to_string(region), outputDenormalization[region]);
+    archive.write("normalizedOutputRange" + std::to_string(region),
+                  toTensor(std::vector<TensorDataType>{normalizedOutputRange[region].first, normalizedOutputRange[region].second}));
+  }
+}
+
+TransformPipeline TransformPipeline::Read(torch::serialize::InputArchive& archive)
+{
+  torch::Tensor version, configuration, thresholds;
+  archive.read("version", version);
+  if (version.numel() != 1 || version.item<int64_t>() != PIPELINE_FORMAT_VERSION) {
+    throw std::runtime_error("unsupported version of the transform pipeline");
+  }
+  archive.read("configuration", configuration);
+  archive.read("thresholds", thresholds);
+  auto configurationValues = configuration.to(torch::kInt64).contiguous();
+  auto thresholdValues = toVector(thresholds);
+  if (configurationValues.numel() != 6 || thresholdValues.size() != 2) {
+    throw std::runtime_error("invalid configuration of the transform pipeline");
+  }
+
+  TransformPipeline pipeline{};
+  auto values = configurationValues.data_ptr<int64_t>();
+  pipeline.numberOfInputVariables = static_cast<uint32_t>(values[0]);
+  pipeline.numberOfOutputVariables = static_cast<uint32_t>(values[1]);
+  pipeline.mixedScaling = values[2] != 0;
+  pipeline.thresholdVariable = static_cast<uint32_t>(values[3]);
+  pipeline.outputScaling = {static_cast<Scaling>(values[4]), static_cast<Scaling>(values[5])};
+  pipeline.threshold = thresholdValues[0];
+  pipeline.normalizedThreshold = thresholdValues[1];
+
+  std::vector<torch::Tensor> minMaxTensors(6);
+  for (size_t i = 0; i < minMaxTensors.size(); ++i) {
+    archive.read("minMax" + std::to_string(i), minMaxTensors[i]);
+  }
+  pipeline.minMax = std::make_pair(toMinMaxVector(minMaxTensors[0]), toMinMaxVector(minMaxTensors[1]));
+  pipeline.mixedMinMax = std::make_pair(std::make_pair(toMinMaxVector(minMaxTensors[2]), toMinMaxVector(minMaxTensors[3])),
+                                        std::make_pair(toMinMaxVector(minMaxTensors[4]), toMinMaxVector(minMaxTensors[5])));
+
+  auto readTransform = [&archive](std::string const& name, uint32_t numberOfColumns) {
+    torch::Tensor scale, offset;
+    archive.read(name + "Scale", scale);
+    archive.read(name + "Offset", offset);
+    AffineTransform transform{toVector(scale), toVector(offset)};
+    if (transform.scale.size() != numberOfColumns || transform.offset.size() != numberOfColumns) {
+      throw std::runtime_error("invalid coefficients of the transform pipeline");
+    }
+    return transform;
+  };
+  pipeline.inputNormalization = readTransform("inputNormalization", pipeline.numberOfInputVariables);
+  pipeline.inputDenormalization = readTransform("inputDenormalization", pipeline.numberOfInputVariables);
+  for (size_t region = 0; region < NUMBER_OF_REGIONS; ++region) {
+    pipeline.outputNormalization[region] = readTransform("outputNormalization" + std::to_string(region), pipeline.numberOfOutputVariables);
+    pipeline.outputDenormalization[region] = readTransform("outputDenormalization" + std::to_string(region), pipeline.numberOfOutputVariables);
+
+    torch::Tensor range;
+    archive.read("normalizedOutputRange" + std::to_string(region), range);
+    auto rangeValues = toVector(range);
+    if (rangeValues.size() != 2) {
+      throw std::runtime_error("invalid range of the transform pipeline");
+    }
+    pipeline.normalizedOutputRange[region] = std::make_pair(rangeValues[0], rangeValues[1]);
+  }
+
+  return pipeline;
+}
+
+bool TransformPipeline::save(FilePath const& path) const
+{
+  try {
+    torch::serialize::OutputArchive archive{};
+    write(archive);
+    archive.save_to(path);
+  } catch (std::exception const& e) {
+    std::cout << "Error: Unable to save the transform pipeline to \"" << path << "\": " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+std::optional<TransformPipeline> TransformPipeline::Load(FilePath const& path)
+{
+  try {
+    torch::serialize::InputArchive archive{};
+    archive.load_from(path);
+    return std::make_optional(Read(archive));
+  } catch (std::exception const& e) {
+    std::cout << "Error: Unable to load the transform pipeline from \"" << path << "\": " << e.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
+}